@@ -64,8 +64,10 @@ void loop( void ) ;
 #include "WMath.h"
 #include "HardwareSerial.h"
 #include "pulse.h"
+#include "edge_capture.h"
 #endif
 #include "delay.h"
+#include "core_idle.h"
 #ifdef __cplusplus
 #include "drivers/usart/Usart.h"
 #endif
@@ -17,6 +17,7 @@ public:
     {
         this->buffer = new TElement[capacity];
         CORE_ASSERT(this->buffer != nullptr, "");
+        this->free_buffer = true;
 
         this->_capacity = capacity;
         clear();
@@ -24,13 +25,15 @@ public:
 
     /**
      * @brief Construct a new Ring Buffer object with the given buffer and capacity
+     * @param free_buffer if true, the buffer is freed using delete[] when the RingBuffer is destroyed.
+     *                    set to false for buffers that are not allocated using new[], e.g. static buffers
      * @note the buffer must be at least the size of the capacity
-     * @note the buffer will be freed when the RingBuffer is destroyed
      */
-    RingBuffer(TElement *buffer, size_t capacity)
+    RingBuffer(TElement *buffer, size_t capacity, bool free_buffer = true)
     {
         this->buffer = buffer;
         this->_capacity = capacity;
+        this->free_buffer = free_buffer;
         clear();
     }
 
@@ -39,7 +42,10 @@ public:
      */
     ~RingBuffer()
     {
-        delete[] this->buffer;
+        if (this->free_buffer)
+        {
+            delete[] this->buffer;
+        }
     }
 
     /**
@@ -221,6 +227,11 @@ private:
      */
     volatile TElement *buffer;
 
+    /**
+     * @brief whether the data buffer is freed when the RingBuffer is destroyed
+     */
+    bool free_buffer;
+
     /**
      * @brief the length of the data buffer
      */
@@ -0,0 +1,51 @@
+#include "Tone.h"
+#include "drivers/timera/timera_tone.h"
+#include "core_debug.h"
+
+bool tone(gpio_pin_t _pin, uint32_t frequency, uint32_t duration)
+{
+    ASSERT_GPIO_PIN_VALID(_pin, "tone", return false);
+
+    if (frequency == 0)
+    {
+        noTone(_pin);
+        return true;
+    }
+
+    // tones are generated by the TimerA channel of the pin
+    timera_config_t *unit;
+    en_timera_channel_t channel;
+    en_port_func_t port_function;
+    if (!timera_get_assignment(_pin, unit, channel, port_function))
+    {
+        CORE_DEBUG_PRINTF("tone: pin %d has no TimerA assignment, ignored\n", _pin);
+        return false;
+    }
+
+    if (timera_tone_start(unit, channel, _pin, port_function, frequency, duration) != Ok)
+    {
+        CORE_DEBUG_PRINTF("tone: TimerA unit of pin %d is in use, ignored\n", _pin);
+        return false;
+    }
+
+    return true;
+}
+
+void noTone(gpio_pin_t _pin)
+{
+    ASSERT_GPIO_PIN_VALID(_pin, "noTone");
+
+    timera_config_t *unit;
+    en_timera_channel_t channel;
+    en_port_func_t port_function;
+    if (!timera_get_assignment(_pin, unit, channel, port_function))
+    {
+        return;
+    }
+
+    // only stop the tone if it is played on this pin
+    if (timera_tone_is_active(unit) && unit->state.tone->pin == _pin)
+    {
+        timera_tone_stop(unit);
+    }
+}
@@ -26,7 +26,14 @@ extern "C"
 
 #include "Arduino.h"
 
-  void tone(gpio_pin_t _pin, uint32_t frequency, uint32_t duration = 0);
+  /**
+   * @brief play a square wave at 50% duty on a pin
+   * @param _pin the pin. must have a TimerA assignment
+   * @param frequency frequency of the tone, in Hz. 0 stops the tone
+   * @param duration duration of the tone, in ms. 0 plays until noTone() is called
+   * @return true if the tone is playing, false if the pin has no TimerA channel or its TimerA unit is in use
+   */
+  bool tone(gpio_pin_t _pin, uint32_t frequency, uint32_t duration = 0);
   void noTone(gpio_pin_t _pin);
 
 #ifdef __cplusplus
@@ -3,6 +3,7 @@
 #include "core_debug.h"
 #include "drivers/gpio/gpio.h"
 #include "drivers/irqn/irqn.h"
+#include "drivers/interrupts/irq_priority.h"
 #include <hc32_ddl.h>
 
 // #region Utilities
@@ -101,7 +102,7 @@ void _attachInterrupt(gpio_pin_t pin, voidFuncPtr handler, IRQn_Type irqn, uint3
 
     // clear pending, set priority and enable
     NVIC_ClearPendingIRQ(irqReg.enIRQn);
-    NVIC_SetPriority(irqReg.enIRQn, DDL_IRQ_PRIORITY_DEFAULT);
+    NVIC_SetPriority(irqReg.enIRQn, IRQ_PRIORITY_EXTINT);
     NVIC_EnableIRQ(irqReg.enIRQn);
 }
 
@@ -127,143 +128,105 @@ void _detachInterrupt(gpio_pin_t pin, IRQn_Type irqn)
 }
 // #endregion
 
-// #region pin to IRQn mapping
-typedef struct pin_to_irqn_mapping_t
+// #region EXTI channel table
+typedef struct exti_channel_t
 {
+    /**
+     * @brief is the channel in use?
+     */
+    bool in_use;
+
+    /**
+     * @brief pin attached to the channel
+     */
     gpio_pin_t pin;
+
+    /**
+     * @brief IRQn assigned to the channel
+     */
     IRQn_Type irqn;
-    struct pin_to_irqn_mapping_t *next;
-} pin_to_irqn_mapping_t;
 
-/**
- * @brief Linked list of pin to IRQn mappings
- */
-pin_to_irqn_mapping_t *pin_to_irqn_mapping = NULL;
+    /**
+     * @brief handler and argument, for attachInterruptArg()
+     */
+    voidFuncPtrParam handler;
+    void *arg;
+} exti_channel_t;
 
 /**
- * @brief insert a pin -> irqn mapping
+ * @brief EXTI channel table, indexed by EXTI channel number
+ * @note there are 16 EXTI channels, and each pin maps to exactly one of them.
+ *       so pin -> channel lookups are constant-time
  */
-inline void insert_pin_to_irqn_mapping(gpio_pin_t pin, IRQn_Type irqn)
-{
-    // create new node
-    pin_to_irqn_mapping_t *node = new pin_to_irqn_mapping_t;
-    CORE_ASSERT(node != nullptr, "");
-
-    node->pin = pin;
-    node->irqn = irqn;
-    node->next = NULL;
-
-    // insert node...
-    if (pin_to_irqn_mapping == NULL)
-    {
-        // ... as head
-        pin_to_irqn_mapping = node;
-    }
-    else
-    {
-        // ... as child of last node:
-        // find last node
-        pin_to_irqn_mapping_t *parent = pin_to_irqn_mapping;
-        while (parent->next != NULL)
-        {
-            parent = parent->next;
-        }
-
-        // set as child
-        parent->next = node;
-    }
-}
+static exti_channel_t exti_channels[16];
 
 /**
- * @brief get a pin -> irqn mapping by pin number
+ * @brief get the channel table entry of a pin
  */
-inline bool get_pin_to_irqn_mapping(gpio_pin_t pin, pin_to_irqn_mapping_t &mapping)
+inline exti_channel_t &get_exti_channel(gpio_pin_t pin)
 {
-    // find node
-    pin_to_irqn_mapping_t *node = pin_to_irqn_mapping;
-    while (node != NULL && node->pin != pin)
-    {
-        node = node->next;
-    }
-
-    // return mapping
-    if (node != NULL && node->pin == pin)
-    {
-        mapping = *node;
-        return true;
-    }
-
-    // not found
-    return false;
+    return exti_channels[mapToExternalInterruptChannel(pin)];
 }
 
 /**
- * @brief remove a pin -> irqn mapping by pin number
+ * @brief get the channel table entry of a pin, if the pin is attached
+ * @return channel table entry, or NULL if the pin is not attached
  */
-inline void remove_pin_to_irqn_mapping(gpio_pin_t pin)
+inline exti_channel_t *get_attached_exti_channel(gpio_pin_t pin)
 {
-    // find node
-    pin_to_irqn_mapping_t *node = pin_to_irqn_mapping;
-    pin_to_irqn_mapping_t *parent = NULL;
-    while (node != NULL && node->pin != pin)
-    {
-        parent = node;
-        node = node->next;
-    }
-
-    // remove node
-    if (node != NULL && node->pin == pin)
-    {
-        // remove node from linked list
-        if (parent != NULL)
-        {
-            parent->next = node->next;
-        }
-        else
-        {
-            pin_to_irqn_mapping = node->next;
-        }
-
-        // free node
-        delete[] node;
-    }
+    exti_channel_t &channel = get_exti_channel(pin);
+    return (channel.in_use && channel.pin == pin) ? &channel : NULL;
 }
 
 /**
- * @brief check if a pin -> irqn mapping exists that uses the given EXTi channel
+ * @brief trampoline for handlers with argument
+ * @tparam CH EXTI channel number
+ * @note the handler is loaded from the table, so a handler can be replaced without touching the vector table
  */
-inline bool is_exti_channel_in_use(en_int_src_t ch)
+template <uint8_t CH>
+static void exti_channel_irq_with_arg(void)
 {
-    // loop over all pin to irqn mappings, check if any of them uses the given channel
-    pin_to_irqn_mapping_t *node = pin_to_irqn_mapping;
-    while (node != NULL)
-    {
-        // check if channel is in use
-        if (mapToInterruptSource(node->pin) == ch)
-        {
-            return true;
-        }
-
-        // next node
-        node = node->next;
-    }
-
-    // channel is not in use
-    return false;
+    const exti_channel_t &channel = exti_channels[CH];
+    channel.handler(channel.arg);
 }
 
+static const voidFuncPtr EXTI_ARG_TRAMPOLINES[16] = {
+    exti_channel_irq_with_arg<0>,
+    exti_channel_irq_with_arg<1>,
+    exti_channel_irq_with_arg<2>,
+    exti_channel_irq_with_arg<3>,
+    exti_channel_irq_with_arg<4>,
+    exti_channel_irq_with_arg<5>,
+    exti_channel_irq_with_arg<6>,
+    exti_channel_irq_with_arg<7>,
+    exti_channel_irq_with_arg<8>,
+    exti_channel_irq_with_arg<9>,
+    exti_channel_irq_with_arg<10>,
+    exti_channel_irq_with_arg<11>,
+    exti_channel_irq_with_arg<12>,
+    exti_channel_irq_with_arg<13>,
+    exti_channel_irq_with_arg<14>,
+    exti_channel_irq_with_arg<15>,
+};
 // #endregion
 
-int attachInterrupt(gpio_pin_t pin, voidFuncPtr callback, uint32_t mode)
+/**
+ * @brief attach a interrupt vector to a pin
+ * @param pin the pin
+ * @param vector handler installed in the vector table
+ * @param handler handler with argument, or NULL if vector is the user handler
+ * @param arg argument passed to handler
+ * @param mode interrupt mode
+ * @return assigned irqn, or -1
+ */
+static int attach_exti_channel(gpio_pin_t pin, voidFuncPtr vector, voidFuncPtrParam handler, void *arg, uint32_t mode)
 {
-    ASSERT_GPIO_PIN_VALID(pin, "attachInterrupt");
-    CORE_ASSERT(callback != NULL, "interrupt callback must not be NULL");
-
     // detach any existing interrupt
     detachInterrupt(pin);
 
     // assert EXTI channel is not already in use
-    if (is_exti_channel_in_use(mapToInterruptSource(pin)))
+    exti_channel_t &channel = get_exti_channel(pin);
+    if (channel.in_use)
     {
         // EXTI channel is already in use
         CORE_DEBUG_PRINTF("attachInterrupt: EXTI channel is already in use for pin=%d\n", pin);
@@ -279,37 +242,58 @@ int attachInterrupt(gpio_pin_t pin, voidFuncPtr callback, uint32_t mode)
         return -1;
     }
 
-    // insert pin -> irqn mapping
-    insert_pin_to_irqn_mapping(pin, irqn);
+    // claim the channel
+    channel.in_use = true;
+    channel.pin = pin;
+    channel.irqn = irqn;
+    channel.handler = handler;
+    channel.arg = arg;
 
     // set the interrupt
-    _attachInterrupt(pin, callback, irqn, mode);
+    _attachInterrupt(pin, vector, irqn, mode);
     CORE_DEBUG_PRINTF("attachInterrupt: pin=%d, irqn=%d, mode=%lu\n", pin, int(irqn), mode);
 
     // return assigned irqn
     return irqn;
 }
 
+int attachInterrupt(gpio_pin_t pin, voidFuncPtr callback, uint32_t mode)
+{
+    ASSERT_GPIO_PIN_VALID(pin, "attachInterrupt");
+    CORE_ASSERT(callback != NULL, "interrupt callback must not be NULL");
+
+    // the callback is installed in the vector table directly, so there is no dispatch overhead
+    return attach_exti_channel(pin, callback, NULL, NULL, mode);
+}
+
+int attachInterruptArg(gpio_pin_t pin, voidFuncPtrParam callback, void *arg, uint32_t mode)
+{
+    ASSERT_GPIO_PIN_VALID(pin, "attachInterruptArg");
+    CORE_ASSERT(callback != NULL, "interrupt callback must not be NULL");
+
+    // the channel's trampoline calls the callback with the argument from the channel table
+    return attach_exti_channel(pin, EXTI_ARG_TRAMPOLINES[mapToExternalInterruptChannel(pin)], callback, arg, mode);
+}
+
 void detachInterrupt(gpio_pin_t pin)
 {
     ASSERT_GPIO_PIN_VALID(pin, "detachInterrupt");
 
-    // get irqn for pin from mapping
-    pin_to_irqn_mapping_t mapping;
-    if (!get_pin_to_irqn_mapping(pin, mapping))
+    // get channel of pin
+    exti_channel_t *channel = get_attached_exti_channel(pin);
+    if (channel == NULL)
     {
-        // no mapping for this pin...
-        // CORE_ASSERT_FAIL("attempted to detach interrupt with no pin mapping")
+        // pin not attached...
         return;
     }
 
     // remove the interrupt
-    IRQn_Type irqn = mapping.irqn;
+    IRQn_Type irqn = channel->irqn;
     _detachInterrupt(pin, irqn);
     CORE_DEBUG_PRINTF("detachInterrupt: pin=%d, irqn=%u\n", pin, irqn);
 
-    // clear irqn assignment and remove mapping
-    remove_pin_to_irqn_mapping(pin);
+    // clear irqn assignment and release channel
+    channel->in_use = false;
     irqn_aa_resign(irqn, "external interrupt");
 }
 
@@ -334,15 +318,14 @@ void setInterruptPriority(gpio_pin_t pin, uint32_t priority)
 {
     ASSERT_GPIO_PIN_VALID(pin, "detachInterrupt");
 
-    // get irqn for pin from mapping
-    pin_to_irqn_mapping_t mapping;
-    if (!get_pin_to_irqn_mapping(pin, mapping))
+    // get channel of pin
+    exti_channel_t *channel = get_attached_exti_channel(pin);
+    if (channel == NULL)
     {
-        // no mapping for this pin...
-        // CORE_ASSERT_FAIL("attempted to detach interrupt with no pin mapping")
+        // pin not attached...
         return;
     }
 
     // set the interrupt priority
-    NVIC_SetPriority(mapping.irqn, priority);
-}
\ No newline at end of file
+    NVIC_SetPriority(channel->irqn, priority);
+}
@@ -45,7 +45,7 @@ extern "C"
    * \return assigned interrupt number, or -1 if the interrupt couldn't be assigned
    *
    * \note
-   * the external interrupt priority is set to DDL_IRQ_PRIORITY_DEFAULT by default.
+   * the external interrupt priority is set to IRQ_PRIORITY_EXTINT by default.
    * use setInterruptPriority() to change it.
    *
    * \note 
@@ -67,6 +67,22 @@ extern "C"
    */
   int attachInterrupt(gpio_pin_t pin, voidFuncPtr callback, uint32_t mode);
 
+  /*
+   * \brief Same as attachInterrupt(), but the callback receives a user-defined argument.
+   *        Useful for class-based drivers, e.g. passing the instance as argument.
+   *
+   * \param pin The pin number to attach the interrupt to
+   * \param callback The function to call when the interrupt occurs
+   * \param arg The argument passed to the callback
+   * \param mode Defines when the interrupt should be triggered.
+   * \return assigned interrupt number, or -1 if the interrupt couldn't be assigned
+   *
+   * \note
+   * the callback is called through a small per-channel trampoline, adding a few cycles of latency
+   * compared to attachInterrupt(). all other notes of attachInterrupt() apply.
+   */
+  int attachInterruptArg(gpio_pin_t pin, voidFuncPtrParam callback, void *arg, uint32_t mode);
+
   /*
    * \brief Turns off the given interrupt.
    *
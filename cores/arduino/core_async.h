@@ -0,0 +1,342 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <utility>
+
+/**
+ * coroutine based async operations.
+ *
+ * a AsyncTask is a C++20 coroutine that waits for operations using co_await, without a stack of its own.
+ * tasks are run by a AsyncExecutor, which is polled from loop(). many I/O bound flows can thus overlap
+ * on a single thread, e.g. writing to two serial ports while waiting for a ADC conversion.
+ *
+ * a operation is any object with a `bool poll()` method, which returns true once the operation completed.
+ * if the operation has a `result()` method, its return value is the result of the co_await expression.
+ * operations can also be polled manually, without coroutines.
+ *
+ * @note opt-in. requires C++20, e.g. build_flags = -std=gnu++20 and build_unflags = -std=gnu++17
+ * @note coroutine frames are allocated using malloc(). if allocation fails, the task is invalid and
+ *       AsyncExecutor::spawn() returns false
+ */
+
+#if !defined(__cpp_impl_coroutine)
+#error "core_async.h requires C++20 coroutine support. compile with -std=gnu++20"
+#endif
+#include <coroutine>
+
+/**
+ * @brief millisecond clock used by async_sleep_ms()
+ */
+#ifndef ASYNC_MILLIS
+#include "delay.h"
+#define ASYNC_MILLIS() millis()
+#endif
+
+/**
+ * @brief a coroutine that is run by a AsyncExecutor, or awaited by another AsyncTask
+ */
+class AsyncTask
+{
+public:
+    struct promise_type;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief awaits a operation, by polling it until it completes
+     * @tparam Operation the operation type. a reference for lvalue operations, which are not copied
+     */
+    template <typename Operation>
+    struct Awaiter
+    {
+        Operation operation;
+
+        bool await_ready()
+        {
+            return operation.poll();
+        }
+
+        void await_suspend(handle_type handle)
+        {
+            handle.promise().poll_fn = [](void *ctx) -> bool
+            {
+                return static_cast<Awaiter *>(ctx)->operation.poll();
+            };
+            handle.promise().poll_ctx = this;
+        }
+
+        auto await_resume()
+        {
+            if constexpr (requires { operation.result(); })
+            {
+                return operation.result();
+            }
+        }
+    };
+
+    struct promise_type
+    {
+        /**
+         * @brief condition the coroutine waits for. nullptr to resume on the next poll
+         */
+        bool (*poll_fn)(void *ctx) = nullptr;
+        void *poll_ctx = nullptr;
+
+        AsyncTask get_return_object() noexcept
+        {
+            return AsyncTask(handle_type::from_promise(*this));
+        }
+
+        static AsyncTask get_return_object_on_allocation_failure() noexcept
+        {
+            return AsyncTask(nullptr);
+        }
+
+        // tasks start on the first poll, and stay around until their owner destroys them
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { abort(); }
+
+        static void *operator new(size_t size) noexcept { return malloc(size); }
+        static void operator delete(void *ptr) noexcept { free(ptr); }
+
+        template <typename Operation>
+        Awaiter<Operation> await_transform(Operation &&operation) noexcept
+        {
+            return Awaiter<Operation>{std::forward<Operation>(operation)};
+        }
+    };
+
+    AsyncTask() = default;
+    AsyncTask(const AsyncTask &) = delete;
+    AsyncTask &operator=(const AsyncTask &) = delete;
+
+    AsyncTask(AsyncTask &&other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) {}
+
+    AsyncTask &operator=(AsyncTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (this->handle)
+            {
+                this->handle.destroy();
+            }
+            this->handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~AsyncTask()
+    {
+        if (this->handle)
+        {
+            this->handle.destroy();
+        }
+    }
+
+    /**
+     * @brief check if the task holds a coroutine
+     * @note false for default constructed tasks, or if the coroutine frame could not be allocated
+     */
+    bool valid() const
+    {
+        return static_cast<bool>(this->handle);
+    }
+
+    /**
+     * @brief check if the coroutine finished
+     * @note invalid tasks are always done
+     */
+    bool done() const
+    {
+        return !this->handle || this->handle.done();
+    }
+
+    /**
+     * @brief resume the coroutine, if the operation it waits for completed
+     * @return true if the coroutine finished
+     */
+    bool poll()
+    {
+        if (this->done())
+        {
+            return true;
+        }
+
+        promise_type &promise = this->handle.promise();
+        if (promise.poll_fn != nullptr && !promise.poll_fn(promise.poll_ctx))
+        {
+            return false;
+        }
+
+        promise.poll_fn = nullptr;
+        this->handle.resume();
+        return this->handle.done();
+    }
+
+private:
+    explicit AsyncTask(handle_type handle)
+        : handle(handle) {}
+
+    handle_type handle = nullptr;
+};
+
+/**
+ * @brief single-threaded executor for AsyncTask coroutines
+ * @tparam N maximum number of tasks
+ */
+template <size_t N>
+class AsyncExecutor
+{
+public:
+    /**
+     * @brief add a task to the executor. it first runs on the next call to run()
+     * @param task the task. the executor takes ownership
+     * @return true if the task was added, false if the task is invalid or the executor is full
+     */
+    bool spawn(AsyncTask &&task)
+    {
+        if (!task.valid())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < N; i++)
+        {
+            if (!this->tasks[i].valid())
+            {
+                this->tasks[i] = std::move(task);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief resume every task whose operation completed. finished tasks are destroyed
+     * @return number of tasks that did not finish yet
+     * @note call from loop()
+     */
+    size_t run()
+    {
+        size_t active = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            if (!this->tasks[i].valid())
+            {
+                continue;
+            }
+
+            if (this->tasks[i].poll())
+            {
+                this->tasks[i] = AsyncTask();
+            }
+            else
+            {
+                active++;
+            }
+        }
+        return active;
+    }
+
+    /**
+     * @brief get the number of tasks in the executor
+     */
+    size_t count() const
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            count += this->tasks[i].valid() ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief get the maximum number of tasks
+     */
+    constexpr size_t capacity() const
+    {
+        return N;
+    }
+
+private:
+    AsyncTask tasks[N];
+};
+
+//
+// generic operations
+//
+
+/**
+ * @brief completes after a number of milliseconds
+ */
+struct AsyncSleep
+{
+    uint32_t start;
+    uint32_t duration;
+
+    bool poll()
+    {
+        return (ASYNC_MILLIS() - this->start) >= this->duration;
+    }
+};
+
+/**
+ * @brief wait for a number of milliseconds
+ * @param ms time to wait, in milliseconds
+ */
+inline AsyncSleep async_sleep_ms(const uint32_t ms)
+{
+    return AsyncSleep{ASYNC_MILLIS(), ms};
+}
+
+/**
+ * @brief completes on the second poll, letting all other tasks run once
+ */
+struct AsyncYield
+{
+    bool polled = false;
+
+    bool poll()
+    {
+        const bool done = this->polled;
+        this->polled = true;
+        return done;
+    }
+};
+
+/**
+ * @brief let all other tasks run once
+ */
+inline AsyncYield async_yield()
+{
+    return AsyncYield{};
+}
+
+/**
+ * @brief completes once a predicate returns true
+ */
+template <typename Predicate>
+struct AsyncUntil
+{
+    Predicate predicate;
+
+    bool poll()
+    {
+        return this->predicate();
+    }
+};
+
+/**
+ * @brief wait until a predicate returns true
+ * @param predicate function or lambda returning bool. called on every poll
+ */
+template <typename Predicate>
+inline AsyncUntil<Predicate> async_until(Predicate predicate)
+{
+    return AsyncUntil<Predicate>{predicate};
+}
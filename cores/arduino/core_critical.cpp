@@ -0,0 +1,72 @@
+#include "core_critical.h"
+
+#ifdef CRITICAL_SECTION_PROFILE_ENABLE
+#include "drivers/dwt/dwt.h"
+
+static volatile uint32_t entry_cycles = 0;
+static void *volatile entry_caller = nullptr;
+static volatile critical_section_stats_t stats = {};
+
+/**
+ * @brief was the section entered with no interrupts masked?
+ * @param state state of the section, as returned by critical_section_enter()
+ * @note a section only changes either PRIMASK or BASEPRI, so the other one still has the value it had on entry.
+ *       this is derived from the masking state instead of a nesting counter, since a interrupt that preempts a
+ *       BASEPRI section may enter critical sections of its own
+ */
+static inline bool is_outermost(const critical_state_t state)
+{
+    if (state & CRITICAL_STATE_PRIMASK_FLAG)
+    {
+        return (state & ~CRITICAL_STATE_PRIMASK_FLAG) == 0 && __get_BASEPRI() == 0;
+    }
+
+    return state == 0 && __get_PRIMASK() == 0;
+}
+
+void _critical_section_profile_enter(void *caller, const critical_state_t state)
+{
+    // only the outermost section is timed.
+    // while it is active, interrupts see masking set and thus never touch the entry values
+    if (is_outermost(state))
+    {
+        entry_caller = caller;
+        entry_cycles = dwt_get_cycles();
+    }
+}
+
+void _critical_section_profile_exit(const critical_state_t state)
+{
+    // called before the masking is restored, so the state is the same as on entry
+    if (!is_outermost(state))
+    {
+        return;
+    }
+
+    const uint32_t elapsed = dwt_get_cycles() - entry_cycles;
+    stats.count++;
+    if (elapsed > stats.max_cycles)
+    {
+        stats.max_cycles = elapsed;
+        stats.max_caller = entry_caller;
+    }
+}
+
+void critical_section_get_stats(critical_section_stats_t *out)
+{
+    const critical_state_t state = critical_section_enter(0);
+    out->count = stats.count;
+    out->max_cycles = stats.max_cycles;
+    out->max_caller = stats.max_caller;
+    critical_section_exit(state);
+}
+
+void critical_section_reset_stats()
+{
+    const critical_state_t state = critical_section_enter(0);
+    stats.count = 0;
+    stats.max_cycles = 0;
+    stats.max_caller = nullptr;
+    critical_section_exit(state);
+}
+#endif // CRITICAL_SECTION_PROFILE_ENABLE
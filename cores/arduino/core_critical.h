@@ -0,0 +1,161 @@
+#pragma once
+#include <stdint.h>
+#include <hc32_ddl.h>
+
+/**
+ * critical sections.
+ *
+ * a critical section masks interrupts up to a priority ceiling using BASEPRI, so interrupts with a higher
+ * priority (lower priority value) than the ceiling keep running. with a ceiling of 0, all interrupts are
+ * masked using PRIMASK.
+ *
+ * critical sections can be nested. each critical_section_enter() must be paired with a critical_section_exit()
+ * using the returned state. a nested section never lowers the ceiling of the outer section.
+ *
+ * with CRITICAL_SECTION_PROFILE_ENABLE defined, the longest time interrupts were masked by a outermost critical
+ * section is recorded, along with the return address of the function that entered it. a section is outermost if
+ * it was entered with neither PRIMASK nor BASEPRI set, so sections entered by interrupts that preempt a BASEPRI
+ * section count towards the preempted section.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief state of a critical section, to restore on exit
+     */
+    typedef uint32_t critical_state_t;
+
+    /**
+     * @brief flag in critical_state_t, set if the section used PRIMASK
+     */
+#define CRITICAL_STATE_PRIMASK_FLAG 0x80000000ul
+
+#ifdef CRITICAL_SECTION_PROFILE_ENABLE
+    /**
+     * @brief critical section statistics
+     */
+    typedef struct critical_section_stats_t
+    {
+        /**
+         * @brief number of outermost critical sections
+         */
+        uint32_t count;
+
+        /**
+         * @brief longest time interrupts were masked, in CPU cycles
+         */
+        uint32_t max_cycles;
+
+        /**
+         * @brief return address of the function that entered the longest critical section
+         * @note look up using addr2line or the map file
+         */
+        void *max_caller;
+    } critical_section_stats_t;
+
+    void _critical_section_profile_enter(void *caller, const critical_state_t state);
+    void _critical_section_profile_exit(const critical_state_t state);
+
+    /**
+     * @brief get the critical section statistics
+     */
+    void critical_section_get_stats(critical_section_stats_t *stats);
+
+    /**
+     * @brief reset the critical section statistics
+     */
+    void critical_section_reset_stats();
+#endif
+
+    /**
+     * @brief enter a critical section
+     * @param ceiling priority ceiling, one of DDL_IRQ_PRIORITY_xx. interrupts with a priority value >= ceiling are masked.
+     *                0 masks all interrupts
+     * @return state to pass to critical_section_exit()
+     */
+    __attribute__((always_inline)) inline critical_state_t critical_section_enter(const uint32_t ceiling)
+    {
+        critical_state_t state;
+        if (ceiling == 0)
+        {
+            state = __get_PRIMASK() | CRITICAL_STATE_PRIMASK_FLAG;
+            __disable_irq();
+        }
+        else
+        {
+            // BASEPRI_MAX only ever raises the masking level, so nesting is safe
+            state = __get_BASEPRI();
+            __set_BASEPRI_MAX(ceiling << (8 - __NVIC_PRIO_BITS));
+        }
+
+#ifdef CRITICAL_SECTION_PROFILE_ENABLE
+        _critical_section_profile_enter(__builtin_return_address(0), state);
+#endif
+        return state;
+    }
+
+    /**
+     * @brief exit a critical section
+     * @param state state returned by the matching critical_section_enter()
+     */
+    __attribute__((always_inline)) inline void critical_section_exit(const critical_state_t state)
+    {
+#ifdef CRITICAL_SECTION_PROFILE_ENABLE
+        _critical_section_profile_exit(state);
+#endif
+
+        if (state & CRITICAL_STATE_PRIMASK_FLAG)
+        {
+            __set_PRIMASK(state & ~CRITICAL_STATE_PRIMASK_FLAG);
+        }
+        else
+        {
+            __set_BASEPRI(state);
+        }
+    }
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief scoped critical section
+ *
+ * @example
+ * {
+ *   CriticalSection cs(DDL_IRQ_PRIORITY_03); // masks interrupts with priority 3 and lower
+ *   ...
+ * }
+ */
+class CriticalSection
+{
+public:
+    __attribute__((always_inline)) inline explicit CriticalSection(const uint32_t ceiling = 0)
+        : state(critical_section_enter(ceiling)) {}
+
+    __attribute__((always_inline)) inline ~CriticalSection()
+    {
+        critical_section_exit(state);
+    }
+
+    CriticalSection(const CriticalSection &) = delete;
+    CriticalSection &operator=(const CriticalSection &) = delete;
+
+private:
+    const critical_state_t state;
+};
+#endif
+
+/**
+ * @brief run a block of code in a critical section
+ * @param ceiling priority ceiling, see critical_section_enter()
+ * @param fn code block
+ */
+#define CORE_CRITICAL_SECTION(ceiling, fn)                                                                             \
+    {                                                                                                                  \
+        const critical_state_t _critical_state = critical_section_enter(ceiling);                                      \
+        fn;                                                                                                            \
+        critical_section_exit(_critical_state);                                                                        \
+    }
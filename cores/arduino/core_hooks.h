@@ -66,7 +66,8 @@ extern "C"
      * the default is restored by the core unless 'CORE_DONT_RESTORE_DEFAULT_CLOCKS' is defined.
      *
      * @note
-     * use "drivers/sysclock/sysclock_util.h" to help with clock configuration
+     * use "drivers/sysclock/sysclock_util.h" to help with clock configuration,
+     * or SYSCLOCK_PLAN_INIT_HOOK() to implement this hook using a configuration planned at compile time
      *
      * @note
      * example workflow:
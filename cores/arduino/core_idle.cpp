@@ -0,0 +1,140 @@
+#include "core_idle.h"
+#include "delay.h"
+#include "drivers/deferred/deferred.h"
+#include "drivers/softtimer/soft_timer.h"
+#include <hc32_ddl.h>
+
+/**
+ * @brief time spent in core_idle(), in systick clock ticks
+ */
+static volatile uint64_t idle_ticks = 0;
+
+/**
+ * @brief start of the current measurement window
+ */
+static uint32_t window_start_ms = 0;
+static uint64_t window_start_idle_ticks = 0;
+
+/**
+ * @brief CPU load of the last completed window, in percent
+ */
+static float load = 0.0f;
+
+/**
+ * @brief main loop statistics
+ */
+static bool loop_started = false;
+static uint32_t loop_last_us = 0;
+static uint32_t loop_count = 0;
+static uint32_t loop_min_us = UINT32_MAX;
+static uint32_t loop_max_us = 0;
+static uint64_t loop_total_us = 0;
+
+/**
+ * @brief complete the measurement window, if it is over
+ */
+static void update_load_window(void)
+{
+    const uint32_t now = millis();
+    const uint32_t elapsed_ms = now - window_start_ms;
+    if (elapsed_ms < CORE_LOAD_WINDOW_MS)
+    {
+        return;
+    }
+
+    const uint64_t idle = idle_ticks - window_start_idle_ticks;
+    const uint64_t total = static_cast<uint64_t>(elapsed_ms) * (SysTick->LOAD + 1);
+    load = idle >= total ? 0.0f : (static_cast<float>(total - idle) * 100.0f) / static_cast<float>(total);
+
+    window_start_ms = now;
+    window_start_idle_ticks = idle_ticks;
+}
+
+void core_idle(void)
+{
+    if (__get_IPSR() != 0)
+    {
+        return;
+    }
+
+    // with interrupts masked, WFI still wakes on a pending interrupt, but the handler only runs after the
+    // idle time was counted.
+    // raw PRIMASK instead of critical_section_enter(): interrupts masked by BASEPRI would not wake WFI, and the
+    // sleep would be profiled as a critical section
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // do not sleep while work waits for yield(), it would be delayed until the next interrupt.
+    // checked with interrupts masked, so work posted after the check still ends the WFI
+    if (deferred_has_pending() || soft_timer_has_pending())
+    {
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    const uint32_t start = SysTick->VAL;
+    __DSB();
+    __WFI();
+    const uint32_t end = SysTick->VAL;
+
+    // systick counts down, and wakes the CPU on reload. so at most one reload happened while sleeping
+    const uint32_t ticks = end <= start ? start - end : start + (SysTick->LOAD + 1) - end;
+    idle_ticks = idle_ticks + ticks;
+
+    __set_PRIMASK(primask);
+
+    update_load_window();
+}
+
+float cpuLoad(void)
+{
+    update_load_window();
+    return load;
+}
+
+uint64_t core_get_idle_us(void)
+{
+    return (idle_ticks * 1000) / (SysTick->LOAD + 1);
+}
+
+void core_get_loop_stats(core_loop_stats_t *stats)
+{
+    stats->count = loop_count;
+    stats->min_us = loop_count > 0 ? loop_min_us : 0;
+    stats->max_us = loop_max_us;
+    stats->avg_us = loop_count > 0 ? static_cast<uint32_t>(loop_total_us / loop_count) : 0;
+}
+
+void core_reset_loop_stats(void)
+{
+    loop_count = 0;
+    loop_min_us = UINT32_MAX;
+    loop_max_us = 0;
+    loop_total_us = 0;
+    loop_started = false;
+}
+
+void core_loop_stats_update(void)
+{
+    const uint32_t now = micros();
+
+    // the first iteration after boot or a reset only sets the start
+    if (loop_started)
+    {
+        const uint32_t duration = now - loop_last_us;
+        loop_count++;
+        loop_total_us += duration;
+        if (duration < loop_min_us)
+        {
+            loop_min_us = duration;
+        }
+        if (duration > loop_max_us)
+        {
+            loop_max_us = duration;
+        }
+    }
+
+    loop_last_us = now;
+    loop_started = true;
+    update_load_window();
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * idle time and CPU load.
+ *
+ * core_idle() sleeps (WFI) until the next interrupt and counts the time spent sleeping.
+ * the CPU load is the share of time not spent in core_idle(), measured over windows of CORE_LOAD_WINDOW_MS.
+ * since SysTick wakes the CPU every millisecond, a single sleep never lasts longer than one SysTick period.
+ *
+ * with CORE_IDLE_SLEEP defined, the main loop calls core_idle() after every loop(), and spin-waits that end
+ * with a interrupt (e.g. Usart::flush()) call it while they wait. otherwise, only delay() with CORE_DELAY_SLEEP
+ * and the idle task of the scheduler sleep, and the load is only meaningful if the application calls core_idle().
+ *
+ * the main loop also records the time between two calls to loop().
+ */
+
+/**
+ * @brief length of the CPU load measurement window, in milliseconds
+ */
+#ifndef CORE_LOAD_WINDOW_MS
+#define CORE_LOAD_WINDOW_MS 1000
+#endif
+
+/**
+ * @brief sleep in a spin-wait that ends with a interrupt, if CORE_IDLE_SLEEP is defined
+ * @note does nothing with CORE_SCHEDULER_ENABLE, since other tasks may be ready. the scheduler sleeps on its own
+ */
+#if defined(CORE_IDLE_SLEEP) && !defined(CORE_SCHEDULER_ENABLE)
+#define CORE_IDLE_WAIT() core_idle()
+#else
+#define CORE_IDLE_WAIT()
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief main loop statistics
+     * @note all times are in microseconds
+     */
+    typedef struct core_loop_stats_t
+    {
+        /**
+         * @brief number of measured loop() iterations
+         */
+        uint32_t count;
+
+        /**
+         * @brief shortest, average and longest time between two calls to loop()
+         * @note the difference between max_us and min_us is the loop jitter
+         */
+        uint32_t min_us;
+        uint32_t avg_us;
+        uint32_t max_us;
+    } core_loop_stats_t;
+
+    /**
+     * @brief sleep until the next interrupt, and count the time as idle
+     * @note does nothing in interrupt context, or while deferred work or software timer callbacks wait for yield()
+     * @note the interrupt that ends the sleep runs after the idle time was counted, so it counts as busy
+     */
+    void core_idle(void);
+
+    /**
+     * @brief get the CPU load of the last completed measurement window
+     * @return the load, in percent [0, 100]
+     */
+    float cpuLoad(void);
+
+    /**
+     * @brief get the total time spent in core_idle() since boot, in microseconds
+     */
+    uint64_t core_get_idle_us(void);
+
+    /**
+     * @brief get the main loop statistics
+     * @param stats the statistics
+     */
+    void core_get_loop_stats(core_loop_stats_t *stats);
+
+    /**
+     * @brief reset the main loop statistics
+     */
+    void core_reset_loop_stats(void);
+
+    /**
+     * @brief record the start of a loop() iteration
+     * @note called by main()
+     */
+    void core_loop_stats_update(void);
+
+#ifdef __cplusplus
+}
+#endif
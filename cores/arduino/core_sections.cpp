@@ -0,0 +1,48 @@
+#include "core_sections.h"
+
+#ifdef CORE_RAM_SECTIONS_ENABLE
+#include "core_debug.h"
+#include <string.h>
+
+// provided by core_sections.ld
+extern "C" uint32_t __core_fast_start__;
+extern "C" uint32_t __core_fast_end__;
+extern "C" const uint32_t __core_fast_load__;
+extern "C" uint32_t __core_fast_bss_start__;
+extern "C" uint32_t __core_fast_bss_end__;
+
+/**
+ * @brief copy CORE_RAMFUNC and CORE_FAST_DATA from flash and zero CORE_FAST_BSS, before any other static constructor runs
+ * @note priority 101 is the first one available to applications
+ */
+__attribute__((constructor(101))) static void core_sections_init(void)
+{
+    memcpy(&__core_fast_start__, &__core_fast_load__, (&__core_fast_end__ - &__core_fast_start__) * sizeof(uint32_t));
+    memset(&__core_fast_bss_start__, 0, (&__core_fast_bss_end__ - &__core_fast_bss_start__) * sizeof(uint32_t));
+
+    // make sure the copied code is visible to instruction fetches
+    __asm__ volatile("dsb\n\tisb" ::: "memory");
+}
+
+static uint8_t pool[CORE_FAST_POOL_SIZE] CORE_FAST_BSS __attribute__((aligned(4)));
+static size_t pool_used = 0;
+
+void *core_fast_alloc(const size_t size)
+{
+    const size_t aligned_size = (size + 3) & ~size_t(3);
+    if (aligned_size > (CORE_FAST_POOL_SIZE - pool_used))
+    {
+        CORE_DEBUG_PRINTF("core_fast_alloc: pool used up, %u bytes requested\n", static_cast<unsigned>(size));
+        return nullptr;
+    }
+
+    void *memory = &pool[pool_used];
+    pool_used += aligned_size;
+    return memory;
+}
+
+size_t core_fast_pool_free()
+{
+    return CORE_FAST_POOL_SIZE - pool_used;
+}
+#endif // CORE_RAM_SECTIONS_ENABLE
@@ -0,0 +1,73 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * fast memory placement.
+ *
+ * code in flash runs with up to 5 wait cycles at 200 MHz, hidden only partially by the flash cache.
+ * SRAMH (0x1FFF8000 - 0x1FFFFFFF, 32 KB) is on the code bus and runs without wait cycles, so hot code and data
+ * placed there runs at full speed.
+ *
+ * when CORE_RAM_SECTIONS_ENABLE is defined, the attributes below place functions and variables in SRAMH.
+ * the define is set by the build script when the 'core_ram_sections' board option is enabled, which also adds
+ * the matching linker script sections. before any static constructor runs, the core copies CORE_RAMFUNC and
+ * CORE_FAST_DATA from flash and zeroes CORE_FAST_BSS.
+ *
+ * without CORE_RAM_SECTIONS_ENABLE, the attributes are empty and everything stays in its default location.
+ */
+
+#ifdef CORE_RAM_SECTIONS_ENABLE
+/**
+ * @brief run a function from SRAMH
+ * @note
+ * the function is never inlined, and called using a long call since SRAMH is out of range of a branch from flash.
+ * functions called by a CORE_RAMFUNC still run from flash, unless they are CORE_RAMFUNC too
+ */
+#define CORE_RAMFUNC __attribute__((section(".core_ramfunc"), noinline, long_call))
+
+/**
+ * @brief place an initialized variable in SRAMH. the initial value is copied from flash on startup
+ */
+#define CORE_FAST_DATA __attribute__((section(".core_fast_data")))
+
+/**
+ * @brief place a zero-initialized variable in SRAMH, e.g. a buffer or task stack. costs no flash
+ */
+#define CORE_FAST_BSS __attribute__((section(".core_fast_bss")))
+
+/**
+ * @brief size of the SRAMH pool used by core_fast_alloc(), in bytes
+ */
+#ifndef CORE_FAST_POOL_SIZE
+#define CORE_FAST_POOL_SIZE 1024
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief allocate memory in SRAMH, from a pool of CORE_FAST_POOL_SIZE bytes
+     * @param size number of bytes to allocate
+     * @return 4-byte aligned memory, or nullptr if the pool is used up
+     * @note memory allocated from the pool cannot be freed. used for buffers that live as long as the
+     *       application, e.g. the Serial ring buffers
+     * @note must not be called from interrupt context
+     */
+    void *core_fast_alloc(const size_t size);
+
+    /**
+     * @brief get the number of free bytes in the pool of core_fast_alloc()
+     */
+    size_t core_fast_pool_free();
+
+#ifdef __cplusplus
+}
+#endif
+#else
+#define CORE_RAMFUNC
+#define CORE_FAST_DATA
+#define CORE_FAST_BSS
+#endif
@@ -0,0 +1,115 @@
+#include "delay.h"
+#include "yield.h"
+#include "core_idle.h"
+#include "drivers/dwt/dwt.h"
+#include "drivers/sysclock/sysclock.h"
+#include "drivers/sysclock/timebase_util.h"
+#include <hc32_ddl.h>
+
+/**
+ * @brief CPU cycles per nanosecond, as reciprocal of (HCLK / 1 GHz)
+ * @note updated when HCLK changes
+ */
+static uint32_t cycles_per_ns = 0;
+static uint32_t cycles_per_ns_hclk = 0;
+
+/**
+ * @brief get the cycles per nanosecond reciprocal for the current HCLK
+ */
+static inline uint32_t get_cycles_per_ns()
+{
+    const uint32_t hclk = SYSTEM_CLOCK_FREQUENCIES.hclk;
+    if (hclk != cycles_per_ns_hclk)
+    {
+        cycles_per_ns = timebase_reciprocal(hclk, 1000000000ul);
+        cycles_per_ns_hclk = hclk;
+    }
+
+    return cycles_per_ns;
+}
+
+void delay(uint32_t dwMs)
+{
+    // the systick interrupt cannot run in interrupt context or with interrupts masked, either by PRIMASK or by
+    // a critical section with a priority ceiling (systick has the lowest priority, so any ceiling masks it).
+    // fall back to the busy delay, as the systick based wait would never end
+    if (__get_IPSR() != 0 || __get_PRIMASK() != 0 || __get_BASEPRI() != 0)
+    {
+        delayNoYield(dwMs);
+        return;
+    }
+
+    uint32_t start = micros();
+    while (dwMs > 0)
+    {
+        yield();
+
+        // count elapsed milliseconds relative to the start, so time spent in yield() is not lost
+        while (dwMs > 0 && (micros() - start) >= 1000)
+        {
+            dwMs--;
+            start += 1000;
+        }
+
+#ifdef CORE_DELAY_SLEEP
+        // sleep until the next interrupt, at the latest the next systick
+        if (dwMs > 0)
+        {
+            core_idle();
+        }
+#endif
+    }
+}
+
+void delayNoYield(uint32_t dwMs)
+{
+    Ddl_Delay1ms(dwMs);
+}
+
+void delayMicroseconds(uint32_t dwUs)
+{
+    // delay in 1 ms steps, so the cycle count fits in 32 bits
+    while (dwUs > 1000)
+    {
+        delayNanoseconds(1000000ul);
+        dwUs -= 1000;
+    }
+
+    delayNanoseconds(dwUs * 1000);
+}
+
+void delayNanoseconds(uint32_t ns)
+{
+    // before core_init() measured the clocks (e.g. in static constructors), HCLK is unknown.
+    // fall back to the DDL delay, which is based on SystemCoreClock
+    if (SYSTEM_CLOCK_FREQUENCIES.hclk == 0)
+    {
+        Ddl_Delay1us((ns / 1000) + (ns % 1000 != 0 ? 1 : 0));
+        return;
+    }
+
+    delayCycles(timebase_scale_ceil(ns, get_cycles_per_ns()));
+}
+
+void delayCycles(uint32_t cycles)
+{
+    // the cycle counter does not count before dwt_init(), so the wait would never end
+    if (!dwt_is_enabled())
+    {
+        dwt_init();
+    }
+
+    const uint32_t start = dwt_get_cycles();
+    while ((dwt_get_cycles() - start) < cycles)
+        ;
+}
+
+uint64_t micros64(void)
+{
+    return systick_micros64();
+}
+
+uint64_t uptime_cycles(void)
+{
+    return systick_uptime_cycles();
+}
@@ -55,21 +55,67 @@ extern "C"
     return systick_micros();
   }
 
+  /**
+   * \brief Returns the number of microseconds since the program started, without rollover.
+   */
+  uint64_t micros64(void);
+
+  /**
+   * \brief Returns the number of CPU cycles since the program started, without rollover.
+   *
+   * \note based on the DWT cycle counter, which does not count while the CPU is sleeping.
+   */
+  uint64_t uptime_cycles(void);
+
   /**
    * \brief Pauses the program for the amount of time (in miliseconds) specified as parameter.
    * (There are 1000 milliseconds in a second.)
    *
+   * yield() is called while waiting, so watchdog reloads and background tasks keep running.
+   * with CORE_DELAY_SLEEP defined, the CPU sleeps (WFI) between calls to yield().
+   *
    * \param dwMs the number of milliseconds to pause (uint32_t)
+   * \note in interrupt context, with interrupts disabled or inside a critical section, this behaves like delayNoYield()
    */
   void delay(uint32_t dwMs);
 
+  /**
+   * \brief Pauses the program for the amount of time (in miliseconds) specified as parameter, without calling yield().
+   *
+   * busy-waits using the calibrated DDL delay loop. use for code that must not yield,
+   * e.g. during initialization or with interrupts disabled.
+   *
+   * \param dwMs the number of milliseconds to pause (uint32_t)
+   */
+  void delayNoYield(uint32_t dwMs);
+
   /**
    * \brief Pauses the program for the amount of time (in microseconds) specified as parameter.
    *
+   * The delay is based on the DWT cycle counter and accurate at any HCLK frequency.
+   *
    * \param dwUs the number of microseconds to pause (uint32_t)
    */
   void delayMicroseconds(uint32_t dwUs);
 
+  /**
+   * \brief Pauses the program for at least the amount of time (in nanoseconds) specified as parameter.
+   *
+   * The delay is based on the DWT cycle counter and accurate at any HCLK frequency.
+   * Call overhead adds a few dozen CPU cycles, so very short delays are rounded up to that.
+   * Before core_init() measured HCLK, the delay is rounded up to whole microseconds.
+   *
+   * \param ns the number of nanoseconds to pause
+   */
+  void delayNanoseconds(uint32_t ns);
+
+  /**
+   * \brief Pauses the program for at least the number of CPU cycles specified as parameter.
+   *
+   * \param cycles the number of CPU (HCLK) cycles to pause
+   */
+  void delayCycles(uint32_t cycles);
+
 #ifdef __cplusplus
 }
 #endif
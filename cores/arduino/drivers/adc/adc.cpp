@@ -1,4 +1,5 @@
 #include "adc.h"
+#include "../interrupts/interrupts.h"
 #include "../../yield.h"
 #include "../../core_debug.h"
 
@@ -88,6 +89,8 @@ void adc_enable_channel(const adc_device_t *device, const uint8_t adc_channel, u
     ASSERT_INITIALIZED(device, STRINGIFY(adc_enable_channel));
     ASSERT_CHANNEL_ID(device, adc_channel);
     CORE_ASSERT(sample_time > 0, "adc channel sample_time must be > 0")
+    CORE_ASSERT((device->state.seq_b.channels & adc_channel_to_mask(device, adc_channel)) == 0,
+                "adc channel is already used by sequence B", return);
 
     ADC_DEBUG_PRINTF(device, "enable channel %d, sample_time=%d\n", adc_channel, sample_time);
     stc_adc_ch_cfg_t channel_config = {
@@ -108,6 +111,12 @@ void adc_disable_channel(const adc_device_t *device, const uint8_t adc_channel)
 
     ASSERT_CHANNEL_ID(device, adc_channel);
 
+    if ((device->state.seq_b.channels & adc_channel_to_mask(device, adc_channel)) != 0)
+    {
+        // channel belongs to sequence B, don't touch it
+        return;
+    }
+
     ADC_DEBUG_PRINTF(device, "disable channel %d\n", adc_channel);
     ADC_DelAdcChannel(device->adc.register_base, adc_channel_to_mask(device, adc_channel));
 }
@@ -156,3 +165,307 @@ uint16_t adc_conversion_read_result(const adc_device_t *device, const uint8_t ad
     uint16_t *conversion_results = (uint16_t *)(&device->adc.register_base->DR0);
     return conversion_results[adc_channel];
 }
+
+//
+// ADC analog watchdog API
+//
+// the ADC only has a single compare window (AWDDR0 / AWDDR1) that is shared by all channels.
+// per-channel windows are emulated by programming the intersection of all windows into the hardware.
+// any result that leaves a channel's own window also leaves the intersection, so the hardware flags it.
+// the interrupt handler then checks each flagged channel against its own window before calling the callback.
+//
+
+/**
+ * @brief update the hardware compare window to the intersection of all channel windows
+ */
+inline void adc_awd_update_window(const adc_device_t *device)
+{
+    uint16_t low = 0;
+    uint16_t high = 0xffff;
+    for (uint8_t ch = 0; ch < device->adc.channel_count; ch++)
+    {
+        if ((device->state.awd.channels & adc_channel_to_mask(device, ch)) == 0)
+        {
+            continue;
+        }
+
+        const adc_awd_window_t *window = &device->state.awd.windows[ch];
+        low = window->low > low ? window->low : low;
+        high = window->high < high ? window->high : high;
+    }
+
+    if (low > high)
+    {
+        // windows don't overlap, every conversion will raise an interrupt
+        ADC_DEBUG_PRINTF(device, "awd windows don't overlap, expect frequent interrupts\n");
+    }
+
+    // compare mode 0: flag results outside of [DR0, DR1]
+    stc_adc_awd_cfg_t awd_config = {
+        .enAwdmd = AdcAwdCmpMode_0,
+        .enAwdss = AdcAwdSel_SA_SB,
+        .u16AwdDr0 = low,
+        .u16AwdDr1 = high,
+    };
+    ADC_ConfigAwd(device->adc.register_base, &awd_config);
+}
+
+/**
+ * @brief read and clear analog watchdog channel flags
+ * @return flagged channels, bit n = channel n
+ */
+inline uint32_t adc_awd_get_and_clear_flags(const adc_device_t *device)
+{
+    M4_ADC_TypeDef *adc = device->adc.register_base;
+    const uint16_t flags0 = adc->AWDSR0;
+    const uint16_t flags1 = adc->AWDSR1;
+
+    // flags are cleared by writing 0, writing 1 has no effect
+    adc->AWDSR0 = static_cast<uint16_t>(~flags0);
+    adc->AWDSR1 = static_cast<uint16_t>(~flags1);
+    return static_cast<uint32_t>(flags0) | (static_cast<uint32_t>(flags1) << 16);
+}
+
+void adc_awd_irq_handler(adc_device_t *device)
+{
+    const uint32_t flags = adc_awd_get_and_clear_flags(device) & device->state.awd.channels;
+    const adc_awd_callback_t callback = device->state.awd.callback;
+    if (flags == 0 || callback == NULL)
+    {
+        return;
+    }
+
+    for (uint8_t ch = 0; ch < device->adc.channel_count; ch++)
+    {
+        if ((flags & (1ul << ch)) == 0)
+        {
+            continue;
+        }
+
+        // hardware window is the intersection, so check against the channel's own window
+        const uint16_t value = adc_conversion_read_result(device, ch);
+        const adc_awd_window_t *window = &device->state.awd.windows[ch];
+        if (value < window->low || value > window->high)
+        {
+            callback(device, ch, value);
+        }
+    }
+}
+
+void adc_awd_set_callback(adc_device_t *device, adc_awd_callback_t callback)
+{
+    device->state.awd.callback = callback;
+}
+
+void adc_awd_enable_channel(adc_device_t *device, const uint8_t adc_channel, const uint16_t low, const uint16_t high)
+{
+    ASSERT_INITIALIZED(device, STRINGIFY(adc_awd_enable_channel));
+    ASSERT_CHANNEL_ID(device, adc_channel);
+    CORE_ASSERT(low <= high, "adc awd low threshold must be <= high threshold", return);
+
+    // allocate per-channel windows on first use
+    adc_awd_state_t *awd = &device->state.awd;
+    if (awd->windows == NULL)
+    {
+        awd->windows = new adc_awd_window_t[device->adc.channel_count];
+        CORE_ASSERT(awd->windows != NULL, "adc awd window allocation failed", return);
+    }
+
+    ADC_DEBUG_PRINTF(device, "awd enable channel %d, window=[%d, %d]\n", adc_channel, low, high);
+
+    // update window of this channel and program the hardware window
+    awd->windows[adc_channel] = {
+        .low = low,
+        .high = high,
+    };
+    const bool was_active = awd->channels != 0;
+    awd->channels |= adc_channel_to_mask(device, adc_channel);
+    adc_awd_update_window(device);
+    ADC_AddAwdChannel(device->adc.register_base, adc_channel_to_mask(device, adc_channel));
+
+    // enable the watchdog and its interrupt when the first channel is added
+    if (!was_active)
+    {
+        adc_interrupt_config_t &irq = device->interrupts.analog_watchdog;
+        adc_awd_get_and_clear_flags(device);
+
+        const int irqn = interrupt_register(irq.interrupt_source, irq.interrupt_handler);
+        CORE_ASSERT(irqn >= 0, "adc awd interrupt registration failed", return);
+        irq.interrupt_number = static_cast<IRQn_Type>(irqn);
+
+        NVIC_SetPriority(irq.interrupt_number, IRQ_PRIORITY_ADC);
+        NVIC_ClearPendingIRQ(irq.interrupt_number);
+        NVIC_EnableIRQ(irq.interrupt_number);
+
+        ADC_AwdIntCmd(device->adc.register_base, Enable);
+        ADC_AwdCmd(device->adc.register_base, Enable);
+    }
+}
+
+void adc_awd_disable_channel(adc_device_t *device, const uint8_t adc_channel)
+{
+    adc_awd_state_t *awd = &device->state.awd;
+    if (!device->state.initialized || (awd->channels & adc_channel_to_mask(device, adc_channel)) == 0)
+    {
+        // channel is not monitored
+        return;
+    }
+
+    ADC_DEBUG_PRINTF(device, "awd disable channel %d\n", adc_channel);
+    ADC_DelAwdChannel(device->adc.register_base, adc_channel_to_mask(device, adc_channel));
+    awd->channels &= ~adc_channel_to_mask(device, adc_channel);
+
+    if (awd->channels != 0)
+    {
+        // other channels remain, narrow the hardware window to the remaining channels
+        adc_awd_update_window(device);
+        return;
+    }
+
+    // last channel removed, disable the watchdog and its interrupt
+    adc_interrupt_config_t &irq = device->interrupts.analog_watchdog;
+    ADC_AwdCmd(device->adc.register_base, Disable);
+    ADC_AwdIntCmd(device->adc.register_base, Disable);
+    adc_awd_get_and_clear_flags(device);
+
+    NVIC_DisableIRQ(irq.interrupt_number);
+    NVIC_ClearPendingIRQ(irq.interrupt_number);
+    interrupt_resign(irq.interrupt_number);
+}
+
+//
+// ADC sequence B API
+//
+
+/**
+ * @brief get channels selected in a sequence from the channel selection registers
+ * @return selected channels, bit n = channel n
+ */
+inline uint32_t adc_get_sequence_channels(const adc_device_t *device, const uint8_t sequence)
+{
+    M4_ADC_TypeDef *adc = device->adc.register_base;
+    if (sequence == ADC_SEQ_A)
+    {
+        return static_cast<uint32_t>(adc->CHSELRA0) | (static_cast<uint32_t>(adc->CHSELRA1) << 16);
+    }
+
+    return static_cast<uint32_t>(adc->CHSELRB0) | (static_cast<uint32_t>(adc->CHSELRB1) << 16);
+}
+
+void adc_seq_b_complete_irq_handler(adc_device_t *device)
+{
+    ADC_ClrEocFlag(device->adc.register_base, ADC_SEQ_B);
+
+    const adc_seq_b_callback_t callback = device->state.seq_b.callback;
+    if (callback != NULL)
+    {
+        callback(device);
+    }
+}
+
+void adc_seq_b_enable_channel(adc_device_t *device, const uint8_t adc_channel, uint8_t sample_time)
+{
+    ASSERT_INITIALIZED(device, STRINGIFY(adc_seq_b_enable_channel));
+    ASSERT_CHANNEL_ID(device, adc_channel);
+    CORE_ASSERT(sample_time > 0, "adc channel sample_time must be > 0")
+    CORE_ASSERT(device->init_params.scan_mode >= AdcMode_SAOnceSBOnce, "adc scan mode does not include sequence B", return);
+
+    // a channel may only be part of one sequence
+    const uint32_t mask = adc_channel_to_mask(device, adc_channel);
+    CORE_ASSERT((adc_get_sequence_channels(device, ADC_SEQ_A) & mask) == 0,
+                "adc channel is already used by sequence A", return);
+
+    ADC_DEBUG_PRINTF(device, "seq b enable channel %d, sample_time=%d\n", adc_channel, sample_time);
+    stc_adc_ch_cfg_t channel_config = {
+        .u32Channel = mask,
+        .u8Sequence = ADC_SEQ_B,
+        .pu8SampTime = &sample_time,
+    };
+    ADC_AddAdcChannel(device->adc.register_base, &channel_config);
+    device->state.seq_b.channels |= mask;
+}
+
+void adc_seq_b_disable_channel(adc_device_t *device, const uint8_t adc_channel)
+{
+    const uint32_t mask = adc_channel_to_mask(device, adc_channel);
+    if (!device->state.initialized || (device->state.seq_b.channels & mask) == 0)
+    {
+        // channel is not in sequence B
+        return;
+    }
+
+    ADC_DEBUG_PRINTF(device, "seq b disable channel %d\n", adc_channel);
+    ADC_DelAdcChannel(device->adc.register_base, mask);
+    device->state.seq_b.channels &= ~mask;
+}
+
+void adc_seq_b_set_trigger(adc_device_t *device, const en_event_src_t event)
+{
+    ASSERT_INITIALIZED(device, STRINGIFY(adc_seq_b_set_trigger));
+
+    // trigger events are routed through AOS
+    PWC_Fcg0PeriphClockCmd(PWC_FCG0_PERIPH_AOS, Enable);
+
+    ADC_DEBUG_PRINTF(device, "seq b trigger event %d\n", int(event));
+    stc_adc_trg_cfg_t trigger_config = {
+        .u8Sequence = ADC_SEQ_B,
+        .enTrgSel = AdcTrgsel_TRGX0,
+        .enInTrg0 = event,
+    };
+    ADC_ConfigTriggerSrc(device->adc.register_base, &trigger_config);
+    ADC_TriggerSrcCmd(device->adc.register_base, ADC_SEQ_B, Enable);
+}
+
+void adc_seq_b_clear_trigger(adc_device_t *device)
+{
+    if (!device->state.initialized)
+    {
+        return;
+    }
+
+    ADC_TriggerSrcCmd(device->adc.register_base, ADC_SEQ_B, Disable);
+}
+
+void adc_seq_b_set_callback(adc_device_t *device, adc_seq_b_callback_t callback)
+{
+    ASSERT_INITIALIZED(device, STRINGIFY(adc_seq_b_set_callback));
+
+    const bool was_active = device->state.seq_b.callback != NULL;
+    device->state.seq_b.callback = callback;
+    adc_interrupt_config_t &irq = device->interrupts.seq_b_complete;
+    if (callback != NULL && !was_active)
+    {
+        // first callback set, enable completion interrupt
+        ADC_ClrEocFlag(device->adc.register_base, ADC_SEQ_B);
+
+        const int irqn = interrupt_register(irq.interrupt_source, irq.interrupt_handler);
+        CORE_ASSERT(irqn >= 0, "adc seq b interrupt registration failed", return);
+        irq.interrupt_number = static_cast<IRQn_Type>(irqn);
+
+        NVIC_SetPriority(irq.interrupt_number, IRQ_PRIORITY_ADC);
+        NVIC_ClearPendingIRQ(irq.interrupt_number);
+        NVIC_EnableIRQ(irq.interrupt_number);
+        ADC_SeqITCmd(device->adc.register_base, ADC_SEQ_B, Enable);
+    }
+    else if (callback == NULL && was_active)
+    {
+        // callback removed, disable completion interrupt
+        ADC_SeqITCmd(device->adc.register_base, ADC_SEQ_B, Disable);
+        NVIC_DisableIRQ(irq.interrupt_number);
+        NVIC_ClearPendingIRQ(irq.interrupt_number);
+        interrupt_resign(irq.interrupt_number);
+    }
+}
+
+bool adc_seq_b_is_conversion_completed(const adc_device_t *device)
+{
+    ASSERT_INITIALIZED(device, STRINGIFY(adc_seq_b_is_conversion_completed));
+
+    if (ADC_GetEocFlag(device->adc.register_base, ADC_SEQ_B) != Set)
+    {
+        return false;
+    }
+
+    ADC_ClrEocFlag(device->adc.register_base, ADC_SEQ_B);
+    return true;
+}
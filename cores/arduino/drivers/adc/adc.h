@@ -80,6 +80,141 @@ extern "C"
         return adc_conversion_read_result(device, adc_channel);
     }
 
+    //
+    // analog watchdog API
+    //
+
+    /**
+     * @brief set the callback invoked when a monitored channel leaves its window
+     * @param device ADC device configuration
+     * @param callback callback to invoke. NULL to disable callbacks
+     * @note the callback is called from interrupt context
+     */
+    void adc_awd_set_callback(adc_device_t *device, adc_awd_callback_t callback);
+
+    /**
+     * @brief monitor a channel using the analog watchdog
+     * @param device ADC device configuration
+     * @param adc_channel ADC channel to monitor. must be enabled using adc_enable_channel()
+     * @param low lower threshold. results below this value trigger the callback
+     * @param high upper threshold. results above this value trigger the callback
+     * @note requires adc_device_init() to be called first
+     * @note thresholds are in raw conversion counts at the configured resolution
+     * @note the watchdog only observes conversions, so conversions must be started (or scanning continuously)
+     *       for the callback to fire
+     */
+    void adc_awd_enable_channel(adc_device_t *device, const uint8_t adc_channel, const uint16_t low, const uint16_t high);
+
+    /**
+     * @brief stop monitoring a channel using the analog watchdog
+     * @param device ADC device configuration
+     * @param adc_channel ADC channel to stop monitoring
+     * @note if the channel is not monitored, this function will do nothing
+     */
+    void adc_awd_disable_channel(adc_device_t *device, const uint8_t adc_channel);
+
+    //
+    // sequence B API
+    //
+    // sequence B runs independently of sequence A (the sequence used by the functions above).
+    // it has a higher priority and preempts a running sequence A scan, which is restarted afterwards.
+    // sequence B is started by a hardware event, e.g. a timer compare match aligned to a PWM edge.
+    //
+
 #ifdef __cplusplus
+    /**
+     * @brief add a channel to sequence B
+     * @param device ADC device configuration
+     * @param adc_channel ADC channel to enable. must not be enabled in sequence A
+     * @param sample_time ADC sampling time
+     * @note requires adc_device_init() to be called first
+     * @note the device scan mode must include sequence B
+     */
+    void adc_seq_b_enable_channel(adc_device_t *device, const uint8_t adc_channel, uint8_t sample_time = 50);
+#else
+    void adc_seq_b_enable_channel(adc_device_t *device, const uint8_t adc_channel, uint8_t sample_time);
+#endif
+
+    /**
+     * @brief remove a channel from sequence B
+     * @param device ADC device configuration
+     * @param adc_channel ADC channel to disable
+     * @note if the channel is not in sequence B, this function will do nothing
+     */
+    void adc_seq_b_disable_channel(adc_device_t *device, const uint8_t adc_channel);
+
+    /**
+     * @brief set the hardware event that starts sequence B
+     * @param device ADC device configuration
+     * @param event event that triggers the conversion, e.g. EVT_TMRA1_CMP
+     * @note requires adc_device_init() to be called first
+     */
+    void adc_seq_b_set_trigger(adc_device_t *device, const en_event_src_t event);
+
+    /**
+     * @brief disable the hardware trigger of sequence B
+     * @param device ADC device configuration
+     */
+    void adc_seq_b_clear_trigger(adc_device_t *device);
+
+    /**
+     * @brief set the callback invoked when sequence B completes
+     * @param device ADC device configuration
+     * @param callback callback to invoke. NULL to disable the completion interrupt
+     * @note requires adc_device_init() to be called first
+     * @note while a callback is set, adc_seq_b_is_conversion_completed() will not report completion,
+     *       as the interrupt handler clears the completion flag
+     */
+    void adc_seq_b_set_callback(adc_device_t *device, adc_seq_b_callback_t callback);
+
+    /**
+     * @brief check if a sequence B conversion completed since the last call
+     * @param device ADC device configuration
+     * @return true if sequence B completed. the completion flag is cleared
+     * @note requires adc_device_init() to be called first
+     */
+    bool adc_seq_b_is_conversion_completed(const adc_device_t *device);
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief pending conversion, returned by adc_convert_async()
+ * @note poll() starts the conversion on the first call, and returns true once it completed.
+ *       result() is the conversion result of the channel
+ * @note only one conversion per ADC device can be pending at a time
+ */
+struct adc_convert_operation_t
+{
+    const adc_device_t *device;
+    uint8_t adc_channel;
+    bool started;
+
+    bool poll()
+    {
+        if (!this->started)
+        {
+            adc_start_conversion(this->device);
+            this->started = true;
+        }
+        return adc_is_conversion_completed(this->device);
+    }
+
+    uint16_t result()
+    {
+        return adc_conversion_read_result(this->device, this->adc_channel);
+    }
+};
+
+/**
+ * @brief start a conversion and read the result, without blocking
+ * @param device ADC device configuration
+ * @param adc_channel ADC channel to read. must be enabled using adc_enable_channel()
+ * @note use with co_await (see core_async.h), or poll the operation manually
+ * @note requires adc_device_init() to be called first
+ */
+inline adc_convert_operation_t adc_convert_async(const adc_device_t *device, const uint8_t adc_channel)
+{
+    return adc_convert_operation_t{device, adc_channel, false};
 }
 #endif
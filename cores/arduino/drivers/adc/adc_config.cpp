@@ -1,4 +1,5 @@
 #include "adc_config.h"
+#include "adc_handlers.h"
 
 // configurable ADC resolution
 #ifndef CORE_ADC_RESOLUTION
@@ -28,6 +29,16 @@ adc_device_t ADC1_device = {
     .init_params = {
         .resolution = ADC_RESOLUTION,
         .data_alignment = AdcDataAlign_Right,
-        .scan_mode = AdcMode_SAOnce, // only sequence A
+        .scan_mode = AdcMode_SAOnceSBOnce, // sequence A, sequence B only converts when triggered
+    },
+    .interrupts = {
+        .analog_watchdog = {
+            .interrupt_source = INT_ADC1_SEQCMP,
+            .interrupt_handler = ADC1_awd_irq,
+        },
+        .seq_b_complete = {
+            .interrupt_source = INT_ADC1_EOCB,
+            .interrupt_handler = ADC1_seq_b_complete_irq,
+        },
     },
 };
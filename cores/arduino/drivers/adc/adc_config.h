@@ -47,11 +47,127 @@ typedef struct adc_init_params_t
     /**
      * @brief ADC scan mode
      * @note must include sequence set in peripheral config
+     * @note must include sequence B to use the adc_seq_b_* API
      */
     en_adc_scan_mode_t scan_mode;
 
 } adc_init_params_t;
 
+/**
+ * @brief ADC interrupt config
+ */
+typedef struct adc_interrupt_config_t
+{
+    /**
+     * @brief IRQn assigned to this interrupt handler
+     * @note auto-assigned in lib implementation
+     */
+    IRQn_Type interrupt_number;
+
+    /**
+     * @brief interrupt source
+     */
+    en_int_src_t interrupt_source;
+
+    /**
+     * @brief interrupt handler
+     */
+    func_ptr_t interrupt_handler;
+} adc_interrupt_config_t;
+
+/**
+ * @brief ADC interrupts configuration
+ */
+typedef struct adc_interrupts_config_t
+{
+    /**
+     * @brief analog watchdog compare interrupt
+     */
+    adc_interrupt_config_t analog_watchdog;
+
+    /**
+     * @brief sequence B end of conversion interrupt
+     */
+    adc_interrupt_config_t seq_b_complete;
+} adc_interrupts_config_t;
+
+// forward declaration for callback typedefs
+struct adc_device_t;
+
+/**
+ * @brief analog watchdog callback
+ * @param device ADC device the event occurred on
+ * @param adc_channel ADC channel whose conversion result left the window
+ * @param value the conversion result that left the window
+ * @note called from interrupt context
+ */
+typedef void (*adc_awd_callback_t)(const struct adc_device_t *device, const uint8_t adc_channel, const uint16_t value);
+
+/**
+ * @brief analog watchdog window of a single channel
+ */
+typedef struct adc_awd_window_t
+{
+    /**
+     * @brief lower threshold. conversion results below this value are outside the window
+     */
+    uint16_t low;
+
+    /**
+     * @brief upper threshold. conversion results above this value are outside the window
+     */
+    uint16_t high;
+} adc_awd_window_t;
+
+/**
+ * @brief analog watchdog runtime state
+ */
+typedef struct adc_awd_state_t
+{
+    /**
+     * @brief channels monitored by the analog watchdog
+     * @note bit n = channel n
+     */
+    uint32_t channels;
+
+    /**
+     * @brief per-channel windows
+     * @note channel_count entries, allocated on first use. NULL if not allocated
+     */
+    adc_awd_window_t *windows;
+
+    /**
+     * @brief callback invoked when a channel leaves its window
+     */
+    adc_awd_callback_t callback;
+} adc_awd_state_t;
+
+/**
+ * @brief sequence B conversion complete callback
+ * @param device ADC device the conversion completed on
+ * @note called from interrupt context
+ * @note results of sequence B channels can be read using adc_conversion_read_result()
+ */
+typedef void (*adc_seq_b_callback_t)(const struct adc_device_t *device);
+
+/**
+ * @brief sequence B runtime state
+ */
+typedef struct adc_seq_b_state_t
+{
+    /**
+     * @brief channels converted by sequence B
+     * @note bit n = channel n
+     */
+    uint32_t channels;
+
+    /**
+     * @brief callback invoked when sequence B completes
+     * @note NULL if completion interrupt is not used
+     */
+    adc_seq_b_callback_t callback;
+} adc_seq_b_state_t;
+
 /**
  * @brief ADC runtime state
  */
@@ -61,6 +177,16 @@ typedef struct adc_runtime_state_t
      * @brief was the adc already initialized?
      */
     bool initialized;
+
+    /**
+     * @brief analog watchdog state
+     */
+    adc_awd_state_t awd;
+
+    /**
+     * @brief sequence B state
+     */
+    adc_seq_b_state_t seq_b;
 } adc_runtime_state_t;
 
 /**
@@ -78,6 +204,11 @@ typedef struct adc_device_t
      */
     adc_init_params_t init_params;
 
+    /**
+     * @brief ADC interrupts configuration
+     */
+    adc_interrupts_config_t interrupts;
+
     /**
      * @brief ADC runtime state
      */
@@ -0,0 +1,34 @@
+#pragma once
+#include "adc_config.h"
+
+//
+// IRQ handler implementations
+//
+
+/**
+ * @brief analog watchdog compare interrupt handler
+ * @param device ADC device that raised the interrupt
+ * @note implemented in adc.cpp
+ */
+void adc_awd_irq_handler(adc_device_t *device);
+
+/**
+ * @brief sequence B end of conversion interrupt handler
+ * @param device ADC device that raised the interrupt
+ * @note implemented in adc.cpp
+ */
+void adc_seq_b_complete_irq_handler(adc_device_t *device);
+
+//
+// IRQ handler entry points
+//
+
+void ADC1_awd_irq(void)
+{
+    adc_awd_irq_handler(&ADC1_device);
+}
+
+void ADC1_seq_b_complete_irq(void)
+{
+    adc_seq_b_complete_irq_handler(&ADC1_device);
+}
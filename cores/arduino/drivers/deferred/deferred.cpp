@@ -0,0 +1,71 @@
+#include "deferred.h"
+#include "deferred_queue.h"
+#include "../interrupts/irq_priority.h"
+#include "../../core_debug.h"
+#include <hc32_ddl.h>
+
+static DeferredQueue<DEFERRED_QUEUE_SIZE> queue;
+static volatile uint32_t dropped = 0;
+static volatile uint32_t high_water = 0;
+
+void deferred_init(void)
+{
+#if DEFERRED_USE_PENDSV
+    // lowest priority, so deferred work never delays a real interrupt
+    NVIC_SetPriority(PendSV_IRQn, IRQ_PRIORITY_PENDSV);
+#endif
+}
+
+bool deferred_post(deferred_fn_t fn, void *arg)
+{
+    CORE_ASSERT(fn != nullptr, "deferred_post: fn is nullptr", return false);
+    if (!queue.push({fn, arg}))
+    {
+        __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    // racy, but only a statistic
+    const uint32_t count = queue.count();
+    if (count > high_water)
+    {
+        high_water = count;
+    }
+
+#if DEFERRED_USE_PENDSV
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#endif
+    return true;
+}
+
+void deferred_run(void)
+{
+    deferred_work_t work;
+    while (queue.pop(work))
+    {
+        work.fn(work.arg);
+    }
+}
+
+bool deferred_has_pending(void)
+{
+    return queue.count() != 0;
+}
+
+uint32_t deferred_get_dropped(void)
+{
+    return dropped;
+}
+
+uint32_t deferred_get_high_water(void)
+{
+    return high_water;
+}
+
+// with the scheduler enabled, its PendSV handler runs deferred work before switching tasks
+#if DEFERRED_USE_PENDSV && !defined(CORE_SCHEDULER_ENABLE)
+extern "C" void PendSV_Handler(void)
+{
+    deferred_run();
+}
+#endif
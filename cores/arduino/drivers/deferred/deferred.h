@@ -0,0 +1,87 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * deferred work.
+ *
+ * interrupt handlers post small work items (a function and a argument) to a lock-free queue.
+ * the items are executed later, outside of the hard interrupt context:
+ * - with DEFERRED_USE_PENDSV enabled (default), from the PendSV exception at the lowest interrupt priority.
+ *   items run as soon as no other interrupt is active, and always before loop() continues.
+ * - otherwise, from yield(), e.g. while the main loop is waiting in delay() or Usart::flush().
+ *
+ * items run in the order they were posted. a item must not block, since it delays all other items.
+ */
+
+/**
+ * @brief capacity of the deferred work queue
+ * @note must be a power of two
+ */
+#ifndef DEFERRED_QUEUE_SIZE
+#define DEFERRED_QUEUE_SIZE 32
+#endif
+
+/**
+ * @brief run deferred work from the PendSV exception.
+ * @note set to 0 if PendSV is used by something else, e.g. a RTOS. items then only run from yield()
+ * @note required by CORE_SCHEDULER_ENABLE, which shares PendSV with deferred work
+ */
+#ifndef DEFERRED_USE_PENDSV
+#define DEFERRED_USE_PENDSV 1
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief deferred work function
+     * @param arg the argument passed to deferred_post()
+     */
+    typedef void (*deferred_fn_t)(void *arg);
+
+    /**
+     * @brief initialize deferred work
+     * @note called by core_init()
+     */
+    void deferred_init(void);
+
+    /**
+     * @brief post a work item
+     * @param fn the function to run
+     * @param arg argument passed to the function
+     * @return true if the item was queued, false if the queue is full
+     * @note safe to call from any interrupt priority. never blocks and never masks interrupts
+     */
+    bool deferred_post(deferred_fn_t fn, void *arg);
+
+    /**
+     * @brief run all queued work items
+     * @note called by PendSV, or by yield() if DEFERRED_USE_PENDSV is 0
+     * @note with DEFERRED_USE_PENDSV, do not call this from thread mode. a item posted during the run pends PendSV,
+     *       which would then run later items before the current one has finished
+     */
+    void deferred_run(void);
+
+    /**
+     * @brief check if any work items are queued
+     * @note only a snapshot, unless called with interrupts masked
+     */
+    bool deferred_has_pending(void);
+
+    /**
+     * @brief get the number of items that were dropped because the queue was full
+     */
+    uint32_t deferred_get_dropped(void);
+
+    /**
+     * @brief get the highest number of items that were queued at the same time
+     * @note use to tune DEFERRED_QUEUE_SIZE
+     */
+    uint32_t deferred_get_high_water(void);
+
+#ifdef __cplusplus
+}
+#endif
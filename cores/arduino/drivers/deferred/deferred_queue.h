@@ -0,0 +1,153 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "deferred.h"
+
+/**
+ * bounded lock-free multi-producer / multi-consumer queue of work items.
+ *
+ * every cell carries a sequence number that tells producers and consumers whether the cell is free or
+ * holds a published item. claiming a cell is a single compare-and-swap on the head or tail index, so
+ * posting from any interrupt priority never blocks and never masks interrupts.
+ *
+ * a producer that was preempted after claiming a cell but before publishing it makes the consumer stop
+ * at that cell. the item is then picked up by the next run, which the producer triggers after publishing.
+ */
+
+/**
+ * @brief a work item
+ */
+struct deferred_work_t
+{
+    deferred_fn_t fn;
+    void *arg;
+};
+
+/**
+ * @brief the queue
+ * @tparam N capacity of the queue. must be a power of two
+ */
+template <uint32_t N>
+class DeferredQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "DeferredQueue capacity must be a power of two");
+
+public:
+    DeferredQueue()
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            cells[i].sequence = i;
+        }
+    }
+
+    /**
+     * @brief add a work item to the queue
+     * @param work the item
+     * @return true if the item was added, false if the queue is full
+     * @note safe to call from any context
+     */
+    bool push(const deferred_work_t &work)
+    {
+        uint32_t pos = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        cell_t *cell;
+        for (;;)
+        {
+            cell = &cells[pos & (N - 1)];
+            const uint32_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+            const int32_t diff = static_cast<int32_t>(sequence - pos);
+            if (diff == 0)
+            {
+                // cell is free, try to claim it
+                if (__atomic_compare_exchange_n(&tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                {
+                    break;
+                }
+
+                // pos was updated by the failed exchange
+            }
+            else if (diff < 0)
+            {
+                // cell still holds a item from the previous round
+                return false;
+            }
+            else
+            {
+                // another producer claimed the cell
+                pos = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+            }
+        }
+
+        cell->work = work;
+        __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief take the oldest work item from the queue
+     * @param work the item
+     * @return true if a item was taken, false if the queue is empty
+     * @note safe to call from any context
+     */
+    bool pop(deferred_work_t &work)
+    {
+        uint32_t pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        cell_t *cell;
+        for (;;)
+        {
+            cell = &cells[pos & (N - 1)];
+            const uint32_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+            const int32_t diff = static_cast<int32_t>(sequence - (pos + 1));
+            if (diff == 0)
+            {
+                // cell holds a published item, try to claim it
+                if (__atomic_compare_exchange_n(&head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // cell is empty, or its producer has not published it yet
+                return false;
+            }
+            else
+            {
+                // another consumer took the item
+                pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+            }
+        }
+
+        work = cell->work;
+        __atomic_store_n(&cell->sequence, pos + N, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief get the number of items in the queue
+     * @note only a snapshot when other contexts use the queue concurrently
+     */
+    uint32_t count() const
+    {
+        return __atomic_load_n(&tail, __ATOMIC_RELAXED) - __atomic_load_n(&head, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * @brief get the capacity of the queue
+     */
+    constexpr uint32_t capacity() const
+    {
+        return N;
+    }
+
+private:
+    struct cell_t
+    {
+        uint32_t sequence;
+        deferred_work_t work;
+    };
+
+    cell_t cells[N];
+    uint32_t head = 0;
+    uint32_t tail = 0;
+};
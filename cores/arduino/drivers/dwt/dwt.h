@@ -0,0 +1,41 @@
+#pragma once
+#include <hc32_ddl.h>
+
+/**
+ * DWT cycle counter.
+ *
+ * the DWT (Data Watchpoint and Trace) unit of the Cortex-M4 contains a free-running 32 bit counter (CYCCNT)
+ * that increments once per CPU clock cycle. it is used for cycle-accurate timestamps.
+ *
+ * @note CYCCNT wraps around after 2^32 cycles (~21 seconds at 200 MHz).
+ *       always calculate differences of timestamps using unsigned subtraction.
+ * @note CYCCNT does not count while the CPU is sleeping (WFI / WFE).
+ */
+
+/**
+ * @brief enable the DWT cycle counter
+ * @note called by core_init(). calling it again does not reset the counter
+ */
+inline void dwt_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief check if the DWT cycle counter is running
+ */
+inline bool dwt_is_enabled()
+{
+    return (CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0 &&
+           (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0;
+}
+
+/**
+ * @brief get the current value of the DWT cycle counter
+ * @return CPU cycles, wraps around at 2^32
+ */
+inline uint32_t dwt_get_cycles()
+{
+    return DWT->CYCCNT;
+}
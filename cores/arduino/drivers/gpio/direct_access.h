@@ -89,3 +89,34 @@
  */
 #define portInputRegister(port) \
     __PORT_OFFSET_REGISTER(M4_PORT->PIDRA, port)
+
+/**
+ * @brief get the output set register for a given port
+ * @param port port number to offset by. both the output of digitalPinToPort and en_port_t are valid inputs
+ * @return pointer to the output set register for the given port
+ *
+ * @note writing a 1 sets the output of the pin high, writing a 0 has no effect
+ * @note see GpioPort in gpio_port.h for a higher-level API
+ */
+#define portSetRegister(port) \
+    __PORT_OFFSET_REGISTER(M4_PORT->POSRA, port)
+
+/**
+ * @brief get the output reset register for a given port
+ * @param port port number to offset by. both the output of digitalPinToPort and en_port_t are valid inputs
+ * @return pointer to the output reset register for the given port
+ *
+ * @note writing a 1 sets the output of the pin low, writing a 0 has no effect
+ */
+#define portResetRegister(port) \
+    __PORT_OFFSET_REGISTER(M4_PORT->PORRA, port)
+
+/**
+ * @brief get the output toggle register for a given port
+ * @param port port number to offset by. both the output of digitalPinToPort and en_port_t are valid inputs
+ * @return pointer to the output toggle register for the given port
+ *
+ * @note writing a 1 toggles the output of the pin, writing a 0 has no effect
+ */
+#define portToggleRegister(port) \
+    __PORT_OFFSET_REGISTER(M4_PORT->POTRA, port)
@@ -0,0 +1,224 @@
+#pragma once
+
+/**
+ * compile-time GPIO access for HC32F460.
+ *
+ * DigitalPin<PIN> resolves port, bit mask and register addresses at compile time,
+ * so write / read / toggle compile down to a single store or load of the POSR, PORR, POTR or PIDR register.
+ * use digitalWrite() / digitalRead() for pins that are only known at runtime.
+ *
+ * general information on the GPIO registers can be found in the HC32F460 user manual, chapter 9.4
+ */
+#ifndef __cplusplus
+#error "fast_gpio.h requires C++"
+#endif
+
+#include <stdint.h>
+#include "../../WVariant.h"
+#include "../../wiring_constants.h"
+#include "../../wiring_digital.h"
+
+#if !defined(VARIANT_GPIO_PIN_PORT) || !defined(VARIANT_GPIO_PIN_BIT)
+#error "variant does not define VARIANT_GPIO_PIN_PORT and VARIANT_GPIO_PIN_BIT"
+#endif
+
+namespace gpio
+{
+  /**
+   * @brief base address of the PORT peripheral (M4_PORT)
+   */
+  constexpr uint32_t PORT_REGISTER_BASE = 0x40053800ul;
+
+  /**
+   * @brief offset between the registers of two consecutive ports
+   */
+  constexpr uint32_t PORT_REGISTER_STRIDE = 0x10;
+
+  /**
+   * @brief offsets of the port registers, relative to the registers of the port
+   */
+  constexpr uint32_t PIDR_OFFSET = 0x00; // input data
+  constexpr uint32_t PODR_OFFSET = 0x04; // output data
+  constexpr uint32_t POER_OFFSET = 0x06; // output enable
+  constexpr uint32_t POSR_OFFSET = 0x08; // output set
+  constexpr uint32_t PORR_OFFSET = 0x0A; // output reset
+  constexpr uint32_t POTR_OFFSET = 0x0C; // output toggle
+
+  /**
+   * @brief compile-time description of a gpio pin
+   */
+  struct pin_description_t
+  {
+    /**
+     * @brief IO port of the pin. matches the values of en_port_t
+     */
+    uint8_t port;
+
+    /**
+     * @brief bit position of the pin in the port registers
+     */
+    uint8_t bit_pos;
+
+    /**
+     * @brief bit mask of the pin in the port registers
+     */
+    constexpr uint16_t mask() const
+    {
+      return static_cast<uint16_t>(1u << bit_pos);
+    }
+  };
+
+  /**
+   * @brief describe a gpio pin
+   * @param pin arduino pin number, e.g. PA5
+   * @return pin description, equal to the pin's PIN_MAP entry
+   */
+  constexpr pin_description_t describe_pin(const gpio_pin_t pin)
+  {
+    return {
+        .port = static_cast<uint8_t>(VARIANT_GPIO_PIN_PORT(pin)),
+        .bit_pos = static_cast<uint8_t>(VARIANT_GPIO_PIN_BIT(pin)),
+    };
+  }
+
+  /**
+   * @brief get the address of a port register
+   * @param port port number, e.g. the port of a pin description
+   * @param offset register offset, e.g. POSR_OFFSET
+   * @return address of the register
+   */
+  constexpr uint32_t port_register_address(const uint8_t port, const uint32_t offset)
+  {
+    return PORT_REGISTER_BASE + (PORT_REGISTER_STRIDE * port) + offset;
+  }
+
+  /**
+   * @brief get the bit-band alias address of a bit in a peripheral register
+   * @param address address of the register
+   * @param bit bit position in the register
+   * @return bit-band alias address of the bit
+   * @note writing to the alias address is a atomic read-modify-write of that single bit
+   */
+  constexpr uint32_t peripheral_bitband_address(const uint32_t address, const uint8_t bit)
+  {
+    return 0x42000000ul + ((address - 0x40000000ul) * 32) + (bit * 4);
+  }
+
+  /**
+   * @brief access a 16 bit port register at a fixed address
+   */
+  inline volatile uint16_t &port_register(const uint32_t address)
+  {
+    return *reinterpret_cast<volatile uint16_t *>(address);
+  }
+} // namespace gpio
+
+/**
+ * @brief gpio pin with compile-time resolved registers
+ * @tparam PIN arduino pin number, e.g. PA5
+ *
+ * @note
+ * the pin must be configured as GPIO first, e.g. using pinMode(PIN, OUTPUT).
+ * mode() only switches between input and output and does not change the pin function or pull-ups.
+ *
+ * @example
+ * using LedPin = DigitalPin<PA5>;
+ * LedPin::mode(OUTPUT);
+ * LedPin::high();
+ * LedPin::toggle();
+ */
+template <gpio_pin_t PIN>
+class DigitalPin
+{
+  static_assert(IS_GPIO_PIN(PIN), "invalid GPIO pin supplied to DigitalPin");
+
+public:
+  /**
+   * @brief description of the pin
+   */
+  static constexpr gpio::pin_description_t description = gpio::describe_pin(PIN);
+
+  /**
+   * @brief IO port of the pin
+   */
+  static constexpr uint8_t port = description.port;
+
+  /**
+   * @brief bit mask of the pin in the port registers
+   */
+  static constexpr uint16_t mask = description.mask();
+
+  /**
+   * @brief addresses of the port registers of the pin
+   */
+  static constexpr uint32_t input_register = gpio::port_register_address(port, gpio::PIDR_OFFSET);
+  static constexpr uint32_t output_register = gpio::port_register_address(port, gpio::PODR_OFFSET);
+  static constexpr uint32_t output_enable_register = gpio::port_register_address(port, gpio::POER_OFFSET);
+  static constexpr uint32_t set_register = gpio::port_register_address(port, gpio::POSR_OFFSET);
+  static constexpr uint32_t reset_register = gpio::port_register_address(port, gpio::PORR_OFFSET);
+  static constexpr uint32_t toggle_register = gpio::port_register_address(port, gpio::POTR_OFFSET);
+
+  /**
+   * @brief bit-band alias of the pin's output enable bit
+   */
+  static constexpr uint32_t output_enable_bitband = gpio::peripheral_bitband_address(output_enable_register, description.bit_pos);
+
+  /**
+   * @brief set the pin high
+   */
+  static inline void high()
+  {
+    gpio::port_register(set_register) = mask;
+  }
+
+  /**
+   * @brief set the pin low
+   */
+  static inline void low()
+  {
+    gpio::port_register(reset_register) = mask;
+  }
+
+  /**
+   * @brief write the pin
+   * @param value true = high, false = low
+   */
+  static inline void write(const bool value)
+  {
+    gpio::port_register(value ? set_register : reset_register) = mask;
+  }
+
+  /**
+   * @brief toggle the pin
+   */
+  static inline void toggle()
+  {
+    gpio::port_register(toggle_register) = mask;
+  }
+
+  /**
+   * @brief read the pin
+   * @return true = high, false = low
+   * @note valid in both input and output mode
+   */
+  static inline bool read()
+  {
+    return (gpio::port_register(input_register) & mask) != 0;
+  }
+
+  /**
+   * @brief switch the pin between input and output
+   * @param mode OUTPUT or INPUT. other modes are passed to pinMode()
+   */
+  static inline void mode(const uint32_t mode)
+  {
+    if (mode == OUTPUT || mode == INPUT)
+    {
+      *reinterpret_cast<volatile uint32_t *>(output_enable_bitband) = (mode == OUTPUT) ? 1 : 0;
+    }
+    else
+    {
+      pinMode(PIN, mode);
+    }
+  }
+};
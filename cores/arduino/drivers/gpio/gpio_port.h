@@ -0,0 +1,217 @@
+#pragma once
+
+/**
+ * port-wide GPIO access for HC32F460.
+ *
+ * GpioPort reads and writes multiple pins of the same port with a single register access,
+ * using the set (POSR), reset (PORR) and toggle (POTR) registers.
+ * since these registers only affect the bits written as 1, no read-modify-write is required
+ * and the operations are safe to use from interrupt context.
+ *
+ * general information on the GPIO registers can be found in the HC32F460 user manual, chapter 9.4
+ */
+#include <stddef.h>
+#include "fast_gpio.h"
+
+/**
+ * @brief a GPIO port, e.g. PortA
+ *
+ * @example
+ * // endstops on PA1, PA3 and PA4
+ * using Endstops = GpioPortPins<PA1, PA3, PA4>;
+ * uint16_t state = Endstops::read();
+ *
+ * // 8 bit parallel bus on PB0 - PB7
+ * constexpr GpioPort bus = GpioPort::of(PB0);
+ * bus.write(0x00ff, data);
+ */
+class GpioPort
+{
+public:
+  /**
+   * @brief create a port from its port number
+   * @param port port number. matches the values of en_port_t
+   */
+  constexpr explicit GpioPort(const uint8_t port) : _port(port) {}
+
+  /**
+   * @brief get the port a pin belongs to
+   * @param pin arduino pin number, e.g. PA5
+   */
+  static constexpr GpioPort of(const gpio_pin_t pin)
+  {
+    return GpioPort(gpio::describe_pin(pin).port);
+  }
+
+  /**
+   * @brief build a pin mask from a list of pins
+   * @param pins list of arduino pin numbers. all pins must be on the same port
+   * @param count number of pins in the list
+   * @param port the port of the pins
+   * @param mask the mask of the pins
+   * @return true if the mask was built, false if a pin is invalid or the pins are on different ports
+   */
+  static bool mask_of(const gpio_pin_t *pins, const size_t count, uint8_t &port, uint16_t &mask)
+  {
+    mask = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+      if (!IS_GPIO_PIN(pins[i]))
+      {
+        return false;
+      }
+
+      const gpio::pin_description_t pin = gpio::describe_pin(pins[i]);
+      if (i == 0)
+      {
+        port = pin.port;
+      }
+      else if (pin.port != port)
+      {
+        return false;
+      }
+
+      mask |= pin.mask();
+    }
+
+    return count > 0;
+  }
+
+  /**
+   * @brief get the port number
+   */
+  constexpr uint8_t number() const
+  {
+    return _port;
+  }
+
+  /**
+   * @brief sample all pins of the port
+   * @return input state of the port, bit n = pin n
+   */
+  inline uint16_t read() const
+  {
+    return gpio::port_register(reg(gpio::PIDR_OFFSET));
+  }
+
+  /**
+   * @brief get the output state of the port
+   * @return output state of the port, bit n = pin n
+   */
+  inline uint16_t read_output() const
+  {
+    return gpio::port_register(reg(gpio::PODR_OFFSET));
+  }
+
+  /**
+   * @brief write the pins in a mask
+   * @param mask pins to write, bit n = pin n
+   * @param value value to write. bits not in mask are ignored
+   * @note
+   * setting and clearing are two consecutive stores (POSR, then PORR).
+   * each store is atomic, but pins being set change one bus cycle before pins being cleared.
+   */
+  inline void write(const uint16_t mask, const uint16_t value) const
+  {
+    gpio::port_register(reg(gpio::POSR_OFFSET)) = mask & value;
+    gpio::port_register(reg(gpio::PORR_OFFSET)) = mask & ~value;
+  }
+
+  /**
+   * @brief set the pins in a mask high
+   * @param mask pins to set, bit n = pin n
+   */
+  inline void set(const uint16_t mask) const
+  {
+    gpio::port_register(reg(gpio::POSR_OFFSET)) = mask;
+  }
+
+  /**
+   * @brief set the pins in a mask low
+   * @param mask pins to clear, bit n = pin n
+   */
+  inline void clear(const uint16_t mask) const
+  {
+    gpio::port_register(reg(gpio::PORR_OFFSET)) = mask;
+  }
+
+  /**
+   * @brief toggle the pins in a mask
+   * @param mask pins to toggle, bit n = pin n
+   */
+  inline void toggle(const uint16_t mask) const
+  {
+    gpio::port_register(reg(gpio::POTR_OFFSET)) = mask;
+  }
+
+  /**
+   * @brief switch the pins in a mask between input and output
+   * @param mask pins to switch, bit n = pin n
+   * @param output true to switch to output, false to switch to input
+   * @note the pins must be configured as GPIO first, e.g. using pinMode()
+   * @note this is a read-modify-write of POER and not atomic. don't change the mode of pins
+   *       on the same port from interrupt context at the same time
+   */
+  inline void set_output_enable(const uint16_t mask, const bool output) const
+  {
+    volatile uint16_t &poer = gpio::port_register(reg(gpio::POER_OFFSET));
+    poer = output ? (poer | mask) : (poer & ~mask);
+  }
+
+private:
+  uint8_t _port;
+
+  constexpr uint32_t reg(const uint32_t offset) const
+  {
+    return gpio::port_register_address(_port, offset);
+  }
+};
+
+/**
+ * @brief compile-time mask of pins on the same port
+ * @tparam FIRST first pin
+ * @tparam REST other pins. must be on the same port as FIRST
+ */
+template <gpio_pin_t FIRST, gpio_pin_t... REST>
+class GpioPortPins
+{
+  static_assert(IS_GPIO_PIN(FIRST), "invalid GPIO pin supplied to GpioPortPins");
+  static_assert(((IS_GPIO_PIN(REST)) && ...), "invalid GPIO pin supplied to GpioPortPins");
+  static_assert(((gpio::describe_pin(REST).port == gpio::describe_pin(FIRST).port) && ...),
+                "all pins of GpioPortPins must be on the same port");
+
+public:
+  /**
+   * @brief the port of the pins
+   */
+  static constexpr GpioPort port()
+  {
+    return GpioPort::of(FIRST);
+  }
+
+  /**
+   * @brief the mask of the pins
+   */
+  static constexpr uint16_t mask()
+  {
+    return static_cast<uint16_t>(gpio::describe_pin(FIRST).mask() | (0 | ... | gpio::describe_pin(REST).mask()));
+  }
+
+  /**
+   * @brief sample the pins
+   * @return input state, masked to the pins
+   */
+  static inline uint16_t read()
+  {
+    return port().read() & mask();
+  }
+
+  /**
+   * @brief write the pins
+   * @param value value to write, masked to the pins
+   */
+  static inline void write(const uint16_t value)
+  {
+    port().write(mask(), value);
+  }
+};
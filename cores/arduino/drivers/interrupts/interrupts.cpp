@@ -1,4 +1,6 @@
 #include "interrupts.h"
+#include "irq_profiler.h"
+#include "../../core_critical.h"
 #include "../../core_debug.h"
 #include <algorithm>
 
@@ -19,13 +21,13 @@ constexpr uint8_t VT_MPU_REGION = 0;
    * @param fn code block
    */
   #define RAM_VT_ALLOW_WRITE(fn)                                                                                       \
-    {                                                                                                                  \
+    CORE_CRITICAL_SECTION(0, {                                                                                         \
       mpu::set_region_enabled(VT_MPU_REGION, false);                                                                   \
       fn;                                                                                                              \
       mpu::set_region_enabled(VT_MPU_REGION, true);                                                                    \
-    }
+    })
 #else
-  #define RAM_VT_ALLOW_WRITE(fn) fn
+  #define RAM_VT_ALLOW_WRITE(fn) CORE_CRITICAL_SECTION(0, fn)
 #endif // PROTECT_VECTOR_TABLE
 
 /**
@@ -89,7 +91,7 @@ static inline volatile stc_intc_sel_field_t *get_interrupt_selection_register(co
 static bool is_valid_source_for_irqn(const int irqn, const en_int_src_t source)
 {
   // IRQ < 0 and IRQ > 128 are invalid for the driver
-  // IRQ#128-144 only support shared interrupts using a bit mask, so we don't support them
+  // IRQ#128-143 only support shared interrupts using a bit mask, see interrupt_register_shared()
   if (irqn < 0 || (irqn >= 128 /*&& irqn <= 144*/))
   {
     return false;
@@ -124,17 +126,18 @@ void interrupts_init()
 
   // relocate the vector table to RAM
   // this is done with interrupts disabled and some special memory barriers
-  __disable_irq();
-
-  SCB->VTOR = (uint32_t)target_vt;
-  __DSB();
-
-  __enable_irq();
+  CORE_CRITICAL_SECTION(0, {
+    SCB->VTOR = (uint32_t)target_vt;
+    __DSB();
+  });
 
   // assert the VTOR was actually updated
   // this assertion should always panic, even when core debug is disabled
   CORE_ASSERT(SCB->VTOR == (uint32_t)target_vt, "failed to update VTOR", panic(""))
 
+  // apply priority grouping before any interrupt is registered
+  irq_priority_init();
+
 #if PROTECT_VECTOR_TABLE
   // protect the vector table using the MPU
   mpu::init();
@@ -198,6 +201,223 @@ bool irqn_auto_assign_ex(IRQn_Type &irqn, const en_int_src_t source)
   return false;
 }
 
+bool interrupt_get_source(const int irqn, en_int_src_t &source)
+{
+  CORE_ASSERT(irqn >= 0 && irqn < USEABLE_IRQ_COUNT, "IRQn out of range", return false);
+  if (ram_vector_table.irqs[irqn] == no_handler)
+  {
+    return false;
+  }
+
+  source = static_cast<en_int_src_t>(get_interrupt_selection_register(irqn)->INTSEL);
+  return true;
+}
+
+//
+// shared interrupts (IRQ#128-143)
+//
+
+static_assert(SHARED_IRQ_MAX_HANDLERS <= 32, "SHARED_IRQ_MAX_HANDLERS must be <= 32");
+
+/**
+ * @brief number of shared IRQs
+ */
+constexpr uint8_t SHARED_IRQ_COUNT = 16;
+
+/**
+ * @brief a handler registered to a shared IRQ
+ */
+struct shared_irq_handler_t
+{
+  en_int_src_t source;
+  func_ptr_t handler;
+  shared_irq_pending_t is_pending;
+};
+
+/**
+ * @brief registered shared handlers
+ * @note slot is free if handler == NULL
+ */
+static shared_irq_handler_t shared_handlers[SHARED_IRQ_MAX_HANDLERS];
+
+/**
+ * @brief slots of shared_handlers used by each shared IRQ, bit n = slot n
+ */
+static volatile uint32_t shared_group_slots[SHARED_IRQ_COUNT];
+
+/**
+ * @brief vector table entries replaced by the dispatchers, restored when the last handler of a group is resigned
+ */
+static func_ptr_t shared_previous_vectors[SHARED_IRQ_COUNT];
+
+/**
+ * @brief get the vector source select register (VSSEL) of a shared IRQ group
+ * @param group shared IRQ group, IRQ#(128 + group)
+ */
+static inline volatile uint32_t *get_shared_irq_select_register(const uint8_t group)
+{
+  return reinterpret_cast<volatile uint32_t *>(reinterpret_cast<uint32_t>(&M4_INTC->VSSEL128) +
+                                               (sizeof(uint32_t) * group));
+}
+
+/**
+ * @brief dispatcher of a shared IRQ
+ * @tparam GROUP shared IRQ group, IRQ#(128 + GROUP)
+ */
+template <uint8_t GROUP>
+static void shared_irq_dispatch(void)
+{
+  uint32_t slots = shared_group_slots[GROUP];
+  while (slots != 0)
+  {
+    const uint8_t slot = static_cast<uint8_t>(__builtin_ctz(slots));
+    slots &= slots - 1;
+
+    const shared_irq_handler_t &entry = shared_handlers[slot];
+
+    // only call the handlers of sources that have work.
+    // external interrupts without a check of their own use the EXTI flag of their channel
+    const bool is_pending = entry.is_pending != NULL ? entry.is_pending()
+                                                     : (M4_INTC->EIFR & (1ul << entry.source)) != 0;
+    if (is_pending)
+    {
+      entry.handler();
+    }
+  }
+}
+
+static const func_ptr_t SHARED_IRQ_DISPATCHERS[SHARED_IRQ_COUNT] = {
+    shared_irq_dispatch<0>,
+    shared_irq_dispatch<1>,
+    shared_irq_dispatch<2>,
+    shared_irq_dispatch<3>,
+    shared_irq_dispatch<4>,
+    shared_irq_dispatch<5>,
+    shared_irq_dispatch<6>,
+    shared_irq_dispatch<7>,
+    shared_irq_dispatch<8>,
+    shared_irq_dispatch<9>,
+    shared_irq_dispatch<10>,
+    shared_irq_dispatch<11>,
+    shared_irq_dispatch<12>,
+    shared_irq_dispatch<13>,
+    shared_irq_dispatch<14>,
+    shared_irq_dispatch<15>,
+};
+
+int interrupt_register_shared(const en_int_src_t source, func_ptr_t handler, shared_irq_pending_t is_pending)
+{
+  CORE_ASSERT(handler != NULL, "handler is NULL", return -1);
+  CORE_ASSERT(is_pending != NULL || source <= INT_PORT_EIRQ15, "is_pending is required for this source", return -1);
+
+  const uint8_t group = static_cast<uint8_t>(source / 32);
+  CORE_ASSERT(group < SHARED_IRQ_COUNT, "interrupt source out of range", return -1);
+  const IRQn_Type irqn = static_cast<IRQn_Type>(SHARED_IRQ_BASE + group);
+
+  // find a free slot, and ensure the source is not registered already
+  int free_slot = -1;
+  for (int i = 0; i < SHARED_IRQ_MAX_HANDLERS; i++)
+  {
+    if (shared_handlers[i].handler == NULL)
+    {
+      if (free_slot < 0)
+      {
+        free_slot = i;
+      }
+    }
+    else
+    {
+      CORE_ASSERT(shared_handlers[i].source != source, "source already registered to shared IRQ", return -1);
+    }
+  }
+  CORE_ASSERT(free_slot >= 0, "no free shared IRQ handler slot available", return -1);
+
+  // fill the slot before the dispatcher can see it
+  shared_handlers[free_slot].source = source;
+  shared_handlers[free_slot].handler = handler;
+  shared_handlers[free_slot].is_pending = is_pending;
+
+  const critical_state_t critical_state = critical_section_enter(0);
+  const bool is_first_in_group = shared_group_slots[group] == 0;
+  shared_group_slots[group] |= (1ul << free_slot);
+
+  // the first handler of a group installs the dispatcher
+  if (is_first_in_group)
+  {
+    shared_previous_vectors[group] = ram_vector_table.irqs[irqn];
+
+#ifdef IRQ_PROFILER_ENABLE
+    // install the dispatcher behind the profiler wrapper, the whole group is counted as IRQ#(128 + group)
+    func_ptr_t dispatcher = irq_profiler_install(irqn, SHARED_IRQ_DISPATCHERS[group]);
+#else
+    func_ptr_t dispatcher = SHARED_IRQ_DISPATCHERS[group];
+#endif
+
+    RAM_VT_ALLOW_WRITE({ ram_vector_table.irqs[irqn] = dispatcher; });
+  }
+
+  // enable the source for the shared IRQ
+  *get_shared_irq_select_register(group) |= (1ul << (source & 0x1f));
+  critical_section_exit(critical_state);
+
+  if (is_first_in_group)
+  {
+    NVIC_SetPriority(irqn, SHARED_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(irqn);
+    NVIC_EnableIRQ(irqn);
+  }
+
+  CORE_DEBUG_PRINTF("shared IRQ#%d: registered source %d\n", int(irqn), int(source));
+  return static_cast<int>(irqn);
+}
+
+bool interrupt_resign_shared(const en_int_src_t source)
+{
+  const uint8_t group = static_cast<uint8_t>(source / 32);
+  CORE_ASSERT(group < SHARED_IRQ_COUNT, "interrupt source out of range", return false);
+  const IRQn_Type irqn = static_cast<IRQn_Type>(SHARED_IRQ_BASE + group);
+
+  // find the slot of the source
+  int slot = -1;
+  for (int i = 0; i < SHARED_IRQ_MAX_HANDLERS; i++)
+  {
+    if (shared_handlers[i].handler != NULL && shared_handlers[i].source == source)
+    {
+      slot = i;
+      break;
+    }
+  }
+
+  if (slot < 0)
+  {
+    CORE_DEBUG_PRINTF("cannot resign shared source %d: not registered\n", int(source));
+    return false;
+  }
+
+  // disable the source and remove it from the dispatcher
+  const critical_state_t critical_state = critical_section_enter(0);
+  *get_shared_irq_select_register(group) &= ~(1ul << (source & 0x1f));
+  shared_group_slots[group] &= ~(1ul << slot);
+  const bool is_last_in_group = shared_group_slots[group] == 0;
+  critical_section_exit(critical_state);
+
+  // the last handler of a group removes the dispatcher
+  if (is_last_in_group)
+  {
+    NVIC_DisableIRQ(irqn);
+    NVIC_ClearPendingIRQ(irqn);
+    RAM_VT_ALLOW_WRITE({ ram_vector_table.irqs[irqn] = shared_previous_vectors[group]; });
+
+#ifdef IRQ_PROFILER_ENABLE
+    irq_profiler_remove(irqn);
+#endif
+  }
+
+  shared_handlers[slot].handler = NULL;
+  CORE_DEBUG_PRINTF("shared IRQ#%d: resigned source %d\n", int(irqn), int(source));
+  return true;
+}
+
 //
 // compatibility layer for the old interrupt API
 //
@@ -228,7 +448,14 @@ en_result_t enIrqRegistration(const stc_irq_regi_conf_t *pstcIrqRegiConf)
   // set the handler in the vector table
   CORE_ASSERT(ram_vector_table.irqs[irqn] == no_handler, "IRQn handler already assigned", return ErrorUninitialized);
 
-  RAM_VT_ALLOW_WRITE({ ram_vector_table.irqs[irqn] = pstcIrqRegiConf->pfnCallback; });
+#ifdef IRQ_PROFILER_ENABLE
+  // install the handler behind the profiler wrapper
+  func_ptr_t handler = irq_profiler_install(irqn, pstcIrqRegiConf->pfnCallback);
+#else
+  func_ptr_t handler = pstcIrqRegiConf->pfnCallback;
+#endif
+
+  RAM_VT_ALLOW_WRITE({ ram_vector_table.irqs[irqn] = handler; });
   return Ok;
 }
 
@@ -257,6 +484,10 @@ en_result_t enIrqResign(IRQn_Type enIRQn)
 
   RAM_VT_ALLOW_WRITE({ ram_vector_table.irqs[irqn] = no_handler; });
 
+#ifdef IRQ_PROFILER_ENABLE
+  irq_profiler_remove(irqn);
+#endif
+
   return Ok;
 }
 
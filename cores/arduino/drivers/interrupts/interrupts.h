@@ -3,6 +3,7 @@
 #include <hc32_ddl.h>
 #include <startup.h>
 #include "../irqn/irqn.h"
+#include "irq_priority.h"
 
 /**
  * @brief number of usable IRQ#n
@@ -10,11 +11,31 @@
  */
 #define USEABLE_IRQ_COUNT 128
 
+/**
+ * @brief first shared IRQ#n
+ * @note IRQ#128-143 are shared by groups of 32 interrupt sources each
+ */
+#define SHARED_IRQ_BASE 128
+
+/**
+ * @brief maximum number of handlers registered to shared IRQs at the same time
+ * @note must be <= 32
+ */
+#ifndef SHARED_IRQ_MAX_HANDLERS
+  #define SHARED_IRQ_MAX_HANDLERS 16
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+  /**
+   * @brief check if a source of a shared IRQ has work for its handler
+   * @return true if the handler should be called
+   */
+  typedef bool (*shared_irq_pending_t)(void);
+
   /**
    * @brief initialize dynamic vector table
    * @note called by arduino core init
@@ -37,6 +58,31 @@ extern "C"
    */
   bool interrupt_resign(const int irqn);
 
+  /**
+   * @brief register interrupt handler for specified source on a shared IRQ
+   * @param source interrupt source
+   * @param handler interrupt handler
+   * @param is_pending checks the status flags of the source. only the handlers of pending sources are called.
+   *                   may be NULL for external interrupt sources (EIRQ0-15), for which the EXTI flag is checked
+   * @return shared IRQn the source was assigned to. -1 if failed
+   * @note
+   * sources are assigned to IRQ#128-143 by their number, 32 sources per IRQ (IRQ#(128 + (source / 32))).
+   * there is no common status register telling which source of a group caused the interrupt, so the dispatcher
+   * asks every source of the group using is_pending.
+   * @note
+   * the driver enables the shared IRQ in the NVIC, with priority SHARED_IRQ_PRIORITY.
+   * do not change the NVIC state of the returned IRQn, as it is shared with other handlers.
+   * @note only use shared IRQs for low-rate sources, as dispatching adds latency.
+   */
+  int interrupt_register_shared(const en_int_src_t source, func_ptr_t handler, shared_irq_pending_t is_pending);
+
+  /**
+   * @brief resign interrupt handler for specified source from its shared IRQ
+   * @param source interrupt source
+   * @return true if successful, false if failed
+   */
+  bool interrupt_resign_shared(const en_int_src_t source);
+
   /**
    * @brief automatically assign IRQn for the specified source
    * @param irqn IRQn to assign
@@ -47,6 +93,14 @@ extern "C"
    */
   bool irqn_auto_assign_ex(IRQn_Type &irqn, const en_int_src_t source);
 
+  /**
+   * @brief get the interrupt source assigned to a IRQn
+   * @param irqn IRQn to check, 0-127
+   * @param source the source selected for the IRQn
+   * @return true if a handler is assigned to the IRQn, false if the IRQn is free
+   */
+  bool interrupt_get_source(const int irqn, en_int_src_t &source);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,86 @@
+#include "irq_priority.h"
+#include "interrupts.h"
+#include "../../Print.h"
+#include <stdio.h>
+
+static_assert(IRQ_PRIORITY_PREEMPT_BITS >= 0 && IRQ_PRIORITY_PREEMPT_BITS <= __NVIC_PRIO_BITS,
+              "IRQ_PRIORITY_PREEMPT_BITS must be in range [0, __NVIC_PRIO_BITS]");
+
+#define ASSERT_PRIORITY_IN_RANGE(priority)                                                                             \
+  static_assert((priority) < (1ul << __NVIC_PRIO_BITS), #priority " must be in range [0, 15]")
+
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_USART);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_USART_DMA);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_ADC);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_TIMERA);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_EXTINT);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_TIMER0);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_SOFTWARE_SERIAL);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_WATCHDOG);
+ASSERT_PRIORITY_IN_RANGE(SHARED_IRQ_PRIORITY);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_SYSTICK);
+ASSERT_PRIORITY_IN_RANGE(IRQ_PRIORITY_PENDSV);
+
+/**
+ * @brief PRIGROUP value for the configured number of preempt bits
+ * @note PRIGROUP splits the 8 bit priority field at bit PRIGROUP. only the upper __NVIC_PRIO_BITS are implemented
+ */
+constexpr uint32_t PRIORITY_GROUPING = 7 - IRQ_PRIORITY_PREEMPT_BITS;
+
+void irq_priority_init(void)
+{
+  NVIC_SetPriorityGrouping(PRIORITY_GROUPING);
+}
+
+/**
+ * @brief print the priority of a IRQ
+ * @param out where to print to
+ * @param irqn the IRQ
+ * @param source the interrupt source of the IRQ, or -1 if not applicable
+ * @note system exceptions (irqn < 0) are always enabled
+ */
+static void print_irq_priority(Print &out, const int irqn, const int source)
+{
+  const uint32_t priority = NVIC_GetPriority(static_cast<IRQn_Type>(irqn));
+  uint32_t preempt, sub;
+  NVIC_DecodePriority(priority, NVIC_GetPriorityGrouping(), &preempt, &sub);
+
+  char line[64];
+  snprintf(line, sizeof(line), "%-5d %-7d %-9lu %-8lu %-4lu %s",
+           irqn,
+           source,
+           static_cast<unsigned long>(priority),
+           static_cast<unsigned long>(preempt),
+           static_cast<unsigned long>(sub),
+           (irqn < 0 || NVIC_GetEnableIRQ(static_cast<IRQn_Type>(irqn))) ? "yes" : "no");
+  out.println(line);
+}
+
+void irq_priority_dump(Print &out)
+{
+  char line[48];
+  snprintf(line, sizeof(line), "preempt bits: %d", IRQ_PRIORITY_PREEMPT_BITS);
+  out.println(line);
+
+  out.println("IRQ   source  priority  preempt  sub  enabled");
+  print_irq_priority(out, SysTick_IRQn, -1);
+  print_irq_priority(out, PendSV_IRQn, -1);
+
+  for (int irqn = 0; irqn < USEABLE_IRQ_COUNT; irqn++)
+  {
+    en_int_src_t source;
+    if (interrupt_get_source(irqn, source))
+    {
+      print_irq_priority(out, irqn, static_cast<int>(source));
+    }
+  }
+
+  // shared IRQs have no single source. only list the ones that are in use
+  for (int irqn = SHARED_IRQ_BASE; irqn < SHARED_IRQ_BASE + 16; irqn++)
+  {
+    if (NVIC_GetEnableIRQ(static_cast<IRQn_Type>(irqn)))
+    {
+      print_irq_priority(out, irqn, -1);
+    }
+  }
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <hc32_ddl.h>
+
+/**
+ * interrupt priority plan.
+ *
+ * all core drivers and bundled libraries take the NVIC priority of their interrupts from this table.
+ * every entry can be overridden using build flags or app_config.h, e.g. to make sure a stepper timer
+ * preempts serial traffic.
+ *
+ * priorities are raw NVIC priority values in the range [0, 15], lower values are more urgent.
+ * with IRQ_PRIORITY_PREEMPT_BITS < 4, the upper bits of the value are the preempt priority and the lower
+ * bits are the sub-priority. use IRQ_PRIORITY_ENCODE() to build values in that case.
+ */
+
+/**
+ * @brief number of priority bits used for the preempt priority. the remaining bits are the sub-priority
+ * @note must be in range [0, __NVIC_PRIO_BITS]. the default uses all bits for preemption, like after reset
+ */
+#ifndef IRQ_PRIORITY_PREEMPT_BITS
+  #define IRQ_PRIORITY_PREEMPT_BITS __NVIC_PRIO_BITS
+#endif
+
+/**
+ * @brief build a priority value from a preempt priority and a sub-priority
+ * @param preempt preempt priority. interrupts only preempt each other if their preempt priority differs
+ * @param sub sub-priority. decides the order of pending interrupts with the same preempt priority
+ */
+#define IRQ_PRIORITY_ENCODE(preempt, sub)                                                                              \
+  ((((preempt) << (__NVIC_PRIO_BITS - IRQ_PRIORITY_PREEMPT_BITS)) |                                                     \
+    ((sub) & ((1ul << (__NVIC_PRIO_BITS - IRQ_PRIORITY_PREEMPT_BITS)) - 1))) &                                          \
+   ((1ul << __NVIC_PRIO_BITS) - 1))
+
+//
+// priority table
+//
+
+/**
+ * @brief priority of the USART RX and TX interrupts
+ * @note the TX complete and error interrupts use shared IRQs, with SHARED_IRQ_PRIORITY
+ */
+#ifndef IRQ_PRIORITY_USART
+  #define IRQ_PRIORITY_USART DDL_IRQ_PRIORITY_03
+#endif
+
+/**
+ * @brief priority of the DMA block transfer complete interrupt used by USART RX DMA
+ */
+#ifndef IRQ_PRIORITY_USART_DMA
+  #define IRQ_PRIORITY_USART_DMA DDL_IRQ_PRIORITY_03
+#endif
+
+/**
+ * @brief priority of the ADC sequence and analog watchdog interrupts
+ */
+#ifndef IRQ_PRIORITY_ADC
+  #define IRQ_PRIORITY_ADC DDL_IRQ_PRIORITY_03
+#endif
+
+/**
+ * @brief priority of the TimerA interrupts used by input capture
+ */
+#ifndef IRQ_PRIORITY_TIMERA
+  #define IRQ_PRIORITY_TIMERA DDL_IRQ_PRIORITY_03
+#endif
+
+/**
+ * @brief default priority of external interrupts (attachInterrupt(), edge capture)
+ * @note can be changed per pin at runtime using setInterruptPriority()
+ */
+#ifndef IRQ_PRIORITY_EXTINT
+  #define IRQ_PRIORITY_EXTINT DDL_IRQ_PRIORITY_DEFAULT
+#endif
+
+/**
+ * @brief default priority of Timer0 interrupts
+ * @note can be changed per timer at runtime using Timer0::setCallbackPriority()
+ */
+#ifndef IRQ_PRIORITY_TIMER0
+  #define IRQ_PRIORITY_TIMER0 DDL_IRQ_PRIORITY_DEFAULT
+#endif
+
+/**
+ * @brief priority of the SoftwareSerial bit timer
+ * @note SOFTWARE_SERIAL_TIMER_PRIORITY takes precedence, if defined
+ */
+#ifndef IRQ_PRIORITY_SOFTWARE_SERIAL
+  #define IRQ_PRIORITY_SOFTWARE_SERIAL DDL_IRQ_PRIORITY_03
+#endif
+
+/**
+ * @brief priority of the watchdog interrupt
+ */
+#ifndef IRQ_PRIORITY_WATCHDOG
+  #define IRQ_PRIORITY_WATCHDOG DDL_IRQ_PRIORITY_DEFAULT
+#endif
+
+/**
+ * @brief priority of the shared IRQs (IRQ#128-143), e.g. the USART TX complete and error interrupts
+ */
+#ifndef SHARED_IRQ_PRIORITY
+  #define SHARED_IRQ_PRIORITY DDL_IRQ_PRIORITY_DEFAULT
+#endif
+
+/**
+ * @brief priority of the SysTick exception, which drives millis() and the software timers
+ * @note the default is the lowest priority, like SysTick_Config() sets it
+ */
+#ifndef IRQ_PRIORITY_SYSTICK
+  #define IRQ_PRIORITY_SYSTICK DDL_IRQ_PRIORITY_15
+#endif
+
+/**
+ * @brief priority of the PendSV exception, which runs deferred work and scheduler task switches
+ * @note keep this the lowest priority, so deferred work and task switches never delay a interrupt
+ */
+#ifndef IRQ_PRIORITY_PENDSV
+  #define IRQ_PRIORITY_PENDSV DDL_IRQ_PRIORITY_15
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * @brief apply the priority grouping configured by IRQ_PRIORITY_PREEMPT_BITS
+   * @note called by interrupts_init()
+   */
+  void irq_priority_init(void);
+
+#ifdef __cplusplus
+}
+
+class Print;
+
+/**
+ * @brief print the effective priority of SysTick, PendSV and every assigned IRQ
+ * @param out where to print to, e.g. Serial
+ */
+void irq_priority_dump(Print &out);
+#endif
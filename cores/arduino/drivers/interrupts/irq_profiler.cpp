@@ -0,0 +1,136 @@
+#include "irq_profiler.h"
+
+#ifdef IRQ_PROFILER_ENABLE
+#include "../dwt/dwt.h"
+#include "../../Print.h"
+#include "../../core_debug.h"
+#include "../../core_critical.h"
+#include <stdio.h>
+
+/**
+ * @brief user handlers, indexed by IRQ#n
+ */
+static volatile func_ptr_t profiled_handlers[IRQ_PROFILER_IRQ_COUNT];
+
+/**
+ * @brief statistics, indexed by IRQ#n
+ */
+static irq_profile_t profiles[IRQ_PROFILER_IRQ_COUNT];
+
+/**
+ * @brief cycles spent in profiled handlers since boot
+ * @note used to subtract the time of nested handlers from the preempted handler
+ */
+static volatile uint32_t handler_cycles = 0;
+
+/**
+ * @brief common wrapper installed in the vector table for all profiled IRQs
+ */
+static void irq_profiler_wrapper(void)
+{
+  const uint32_t entry = dwt_get_cycles();
+  const uint32_t handler_cycles_at_entry = handler_cycles;
+
+  // exception number - 16 = IRQ#n
+  const int irqn = static_cast<int>(__get_IPSR() & 0x1ff) - 16;
+  profiled_handlers[irqn]();
+
+  const uint32_t exit = dwt_get_cycles();
+  const uint32_t elapsed = exit - entry;
+
+  // exclude time spent in nested handlers, and account the whole time for the handlers we preempted
+  const uint32_t nested = handler_cycles - handler_cycles_at_entry;
+  const uint32_t self = elapsed - nested;
+  handler_cycles = handler_cycles_at_entry + elapsed;
+
+  irq_profile_t &profile = profiles[irqn];
+  if (profile.count > 0)
+  {
+    const uint32_t interval = entry - profile.last_entry;
+    if (profile.count == 1 || interval < profile.min_interval)
+    {
+      profile.min_interval = interval;
+    }
+    if (interval > profile.max_interval)
+    {
+      profile.max_interval = interval;
+    }
+  }
+
+  profile.count++;
+  profile.total_cycles += self;
+  profile.last_entry = entry;
+  if (self > profile.max_cycles)
+  {
+    profile.max_cycles = self;
+  }
+}
+
+func_ptr_t irq_profiler_install(const int irqn, func_ptr_t handler)
+{
+  CORE_ASSERT(irqn >= 0 && irqn < IRQ_PROFILER_IRQ_COUNT, "IRQn out of range", return handler);
+
+  if (!dwt_is_enabled())
+  {
+    dwt_init();
+  }
+
+  profiles[irqn] = {};
+  profiled_handlers[irqn] = handler;
+  return irq_profiler_wrapper;
+}
+
+void irq_profiler_remove(const int irqn)
+{
+  CORE_ASSERT(irqn >= 0 && irqn < IRQ_PROFILER_IRQ_COUNT, "IRQn out of range", return);
+  profiled_handlers[irqn] = NULL;
+}
+
+bool irq_profiler_get(const int irqn, irq_profile_t &profile)
+{
+  CORE_ASSERT(irqn >= 0 && irqn < IRQ_PROFILER_IRQ_COUNT, "IRQn out of range", return false);
+
+  // copy with interrupts disabled, so the statistics are consistent
+  bool is_profiled;
+  CORE_CRITICAL_SECTION(0, {
+    is_profiled = profiled_handlers[irqn] != NULL;
+    profile = profiles[irqn];
+  });
+  return is_profiled;
+}
+
+void irq_profiler_reset()
+{
+  CORE_CRITICAL_SECTION(0, {
+    for (int i = 0; i < IRQ_PROFILER_IRQ_COUNT; i++)
+    {
+      profiles[i] = {};
+    }
+  });
+}
+
+void irq_profiler_dump(Print &out)
+{
+  // all values in CPU cycles, total in thousands of cycles
+  out.println("IRQ   count       total_k     avg      max      min_int   max_int");
+  for (int irqn = 0; irqn < IRQ_PROFILER_IRQ_COUNT; irqn++)
+  {
+    irq_profile_t profile;
+    if (!irq_profiler_get(irqn, profile) || profile.count == 0)
+    {
+      continue;
+    }
+
+    char line[96];
+    snprintf(line, sizeof(line), "%-5d %-11lu %-11lu %-8lu %-8lu %-9lu %-9lu",
+             irqn,
+             static_cast<unsigned long>(profile.count),
+             static_cast<unsigned long>(profile.total_cycles / 1000),
+             static_cast<unsigned long>(profile.total_cycles / profile.count),
+             static_cast<unsigned long>(profile.max_cycles),
+             static_cast<unsigned long>(profile.count >= 2 ? profile.min_interval : 0),
+             static_cast<unsigned long>(profile.max_interval));
+    out.println(line);
+  }
+}
+#endif // IRQ_PROFILER_ENABLE
@@ -0,0 +1,96 @@
+#pragma once
+#include <hc32_ddl.h>
+
+/**
+ * IRQ profiler.
+ *
+ * when IRQ_PROFILER_ENABLE is defined, every handler registered using enIrqRegistration() (and thus
+ * interrupt_register()) and every shared IRQ dispatcher is installed behind a common wrapper in the RAM
+ * vector table. the wrapper records the DWT cycle counter on entry and exit of the handler and keeps
+ * statistics per IRQ.
+ *
+ * execution times are exclusive: time spent in nested, higher priority handlers is not counted
+ * towards the preempted handler.
+ *
+ * the time between a interrupt becoming pending and its handler being entered cannot be observed
+ * in software. instead, the profiler records the minimum and maximum time between two entries of a handler.
+ * for periodic sources (e.g. a stepper timer), the spread between them is the entry latency jitter.
+ */
+
+/**
+ * @brief number of IRQs the profiler tracks. covers IRQ#0-143
+ */
+#define IRQ_PROFILER_IRQ_COUNT 144
+
+/**
+ * @brief statistics of a single IRQ
+ * @note all times are in CPU cycles
+ */
+typedef struct irq_profile_t
+{
+  /**
+   * @brief number of times the handler was called
+   */
+  uint32_t count;
+
+  /**
+   * @brief total execution time of the handler
+   */
+  uint64_t total_cycles;
+
+  /**
+   * @brief longest execution time of the handler
+   */
+  uint32_t max_cycles;
+
+  /**
+   * @brief shortest and longest time between two consecutive entries of the handler
+   * @note valid once count >= 2
+   */
+  uint32_t min_interval;
+  uint32_t max_interval;
+
+  /**
+   * @brief cycle counter value at the last entry of the handler
+   */
+  uint32_t last_entry;
+} irq_profile_t;
+
+#ifdef IRQ_PROFILER_ENABLE
+/**
+ * @brief install a handler behind the profiler wrapper
+ * @param irqn IRQ#n the handler is registered to
+ * @param handler the handler
+ * @return the wrapper to place in the vector table
+ * @note called by enIrqRegistration() and interrupt_register_shared(). resets the statistics of the IRQ
+ */
+func_ptr_t irq_profiler_install(const int irqn, func_ptr_t handler);
+
+/**
+ * @brief remove a handler from the profiler
+ * @param irqn IRQ#n the handler was registered to
+ * @note called by enIrqResign() and interrupt_resign_shared()
+ */
+void irq_profiler_remove(const int irqn);
+
+/**
+ * @brief get the statistics of a IRQ
+ * @param irqn IRQ#n
+ * @param profile the statistics
+ * @return true if a profiled handler is registered to the IRQ
+ */
+bool irq_profiler_get(const int irqn, irq_profile_t &profile);
+
+/**
+ * @brief reset the statistics of all IRQs
+ */
+void irq_profiler_reset();
+
+class Print;
+
+/**
+ * @brief print the statistics of all profiled IRQs
+ * @param out where to print to, e.g. Serial
+ */
+void irq_profiler_dump(Print &out);
+#endif // IRQ_PROFILER_ENABLE
@@ -1,5 +1,6 @@
 #include "mpu.h"
 #include "../../core_debug.h"
+#include "../../core_critical.h"
 #include <hc32_ddl.h>
 
 #if !__MPU_PRESENT
@@ -39,9 +40,7 @@ inline uint8_t get_region_type(const uint32_t address)
  * @note no interrupts and disable mpu
  */
 #define MPU_CRITICAL_SECTION(fn)                                                                                       \
-  {                                                                                                                    \
-    const bool irqon = !__get_PRIMASK();                                                                               \
-    __disable_irq();                                                                                                   \
+  CORE_CRITICAL_SECTION(0, {                                                                                           \
     uint32_t mpu_ctrl = MPU->CTRL;                                                                                     \
     MPU->CTRL = mpu_ctrl & ~MPU_CTRL_ENABLE_Msk;                                                                       \
     __DSB();                                                                                                           \
@@ -50,8 +49,7 @@ inline uint8_t get_region_type(const uint32_t address)
     }                                                                                                                  \
     __DSB();                                                                                                           \
     MPU->CTRL = mpu_ctrl;                                                                                              \
-    if (irqon) __enable_irq();                                                                                         \
-  }
+  })
 
 namespace mpu
 {
@@ -0,0 +1,403 @@
+#include "scheduler.h"
+
+#ifdef CORE_SCHEDULER_ENABLE
+#include "../deferred/deferred.h"
+#include "../softtimer/soft_timer.h"
+#include "../interrupts/irq_priority.h"
+#include "../../core_hooks.h"
+#include "../../core_debug.h"
+#include "../../core_idle.h"
+#include "../../delay.h"
+#include <hc32_ddl.h>
+
+static_assert(DEFERRED_USE_PENDSV, "CORE_SCHEDULER_ENABLE requires DEFERRED_USE_PENDSV, as the scheduler owns PendSV");
+
+/**
+ * @brief words at the bottom of a task stack that must never change
+ */
+#define STACK_CANARY 0xC0DEC0DEul
+#define STACK_CANARY_WORDS 2
+
+/**
+ * @brief value the rest of a task stack is filled with, to measure its usage
+ */
+#define STACK_FILL 0xA5A5A5A5ul
+
+/**
+ * @brief EXC_RETURN value to return to thread mode, on the main stack, without FPU state
+ */
+#define EXC_RETURN_THREAD_MSP 0xFFFFFFF9ul
+
+/**
+ * @brief the task running setup() and loop()
+ */
+static task_t main_task;
+
+/**
+ * @brief list of all tasks, starting with the main task
+ */
+static task_t *tasks = nullptr;
+
+/**
+ * @brief the running task
+ */
+static task_t *current = nullptr;
+
+/**
+ * @brief the task PendSV switches to. nullptr if no switch is requested
+ */
+static task_t *volatile next_task = nullptr;
+
+/**
+ * @brief check if a task switch is possible in the current context
+ */
+static inline bool can_switch(void)
+{
+    return current != nullptr && __get_IPSR() == 0 && __get_PRIMASK() == 0 && __get_BASEPRI() == 0;
+}
+
+/**
+ * @brief check if a task can run, and wake it if its sleep or wait is over
+ */
+static bool is_ready(task_t *task, const uint32_t now)
+{
+    const bool expired = static_cast<int32_t>(now - task->wake_tick) >= 0;
+    switch (task->state)
+    {
+    case TASK_STATE_READY:
+        return true;
+    case TASK_STATE_SLEEPING:
+        if (expired)
+        {
+            task->state = TASK_STATE_READY;
+            return true;
+        }
+        return false;
+    case TASK_STATE_WAITING:
+        if (task->event->count > 0 || (!task->wait_forever && expired))
+        {
+            task->state = TASK_STATE_READY;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief pick the task to run next
+ * @return the task, or nullptr if no task is ready
+ * @note the search starts after the current task, so tasks with the same priority take turns
+ */
+static task_t *pick_next(void)
+{
+    const uint32_t now = millis();
+    task_t *best = nullptr;
+    task_t *task = current;
+    do
+    {
+        task = task->next != nullptr ? task->next : tasks;
+        if (is_ready(task, now) && (best == nullptr || (SCHEDULER_USE_PRIORITY && task->priority < best->priority)))
+        {
+            best = task;
+        }
+    } while (task != current);
+
+    return best;
+}
+
+/**
+ * @brief background work while no task is ready
+ */
+static void idle(void)
+{
+    // deferred work runs only from PendSV, which preempts this as soon as a item is posted
+    soft_timer_run_pending();
+    core_hook_yield_wdt_reload();
+
+#if SCHEDULER_IDLE_SLEEP
+    // a event signaled just before this is seen on the next interrupt at the latest, i.e. the next tick
+    core_idle();
+#endif
+}
+
+/**
+ * @brief consume a signal of a event
+ * @return true if a signal was consumed
+ */
+static bool try_take(task_event_t *event)
+{
+    uint32_t count = __atomic_load_n(&event->count, __ATOMIC_RELAXED);
+    while (count > 0)
+    {
+        if (__atomic_compare_exchange_n(&event->count, &count, count - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief check the stack of a task that is switched out
+ */
+static void check_stack(const task_t *task)
+{
+    if (task->stack == nullptr)
+    {
+        return;
+    }
+
+    bool ok = task->sp >= reinterpret_cast<uint32_t>(task->stack + STACK_CANARY_WORDS);
+    for (size_t i = 0; i < STACK_CANARY_WORDS; i++)
+    {
+        ok = ok && task->stack[i] == STACK_CANARY;
+    }
+
+    if (!ok)
+    {
+        panic("task stack overflow");
+    }
+}
+
+/**
+ * @brief called when a task function returns
+ */
+static void task_exit(void)
+{
+    current->state = TASK_STATE_DONE;
+    for (;;)
+    {
+        scheduler_yield();
+    }
+}
+
+void scheduler_init(void)
+{
+    main_task.sp = 0;
+    main_task.stack = nullptr;
+    main_task.stack_size = 0;
+    main_task.name = "main";
+    main_task.priority = SCHEDULER_DEFAULT_PRIORITY;
+    main_task.state = TASK_STATE_READY;
+    main_task.event = nullptr;
+    main_task.next = nullptr;
+
+    tasks = &main_task;
+    current = &main_task;
+
+    // lowest priority, so a switch never happens while a interrupt is active
+    NVIC_SetPriority(PendSV_IRQn, IRQ_PRIORITY_PENDSV);
+}
+
+void scheduler_yield(void)
+{
+    if (!can_switch())
+    {
+        return;
+    }
+
+    task_t *next;
+    while ((next = pick_next()) == nullptr)
+    {
+        // no task can run, not even the current one
+        idle();
+    }
+
+    if (next == current)
+    {
+        return;
+    }
+
+    next_task = next;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    __DSB();
+    __ISB();
+}
+
+bool task_create(task_t *task, task_fn_t fn, void *arg, void *stack, size_t stack_size, uint8_t priority, const char *name)
+{
+    CORE_ASSERT(current != nullptr, "task_create: scheduler not initialized", return false);
+    CORE_ASSERT(__get_IPSR() == 0, "task_create: called from interrupt context", return false);
+    CORE_ASSERT(task != nullptr && fn != nullptr && stack != nullptr, "task_create: invalid argument", return false);
+    CORE_ASSERT(stack_size >= SCHEDULER_MIN_STACK_SIZE, "task_create: stack too small", return false);
+
+    // a task that ended is still in the list, and can be created again
+    bool listed = false;
+    for (task_t *t = tasks; t != nullptr; t = t->next)
+    {
+        listed = listed || t == task;
+    }
+    CORE_ASSERT(!listed || (task != current && task->state == TASK_STATE_DONE), "task_create: task already exists", return false);
+
+    // align the stack to 8 bytes, as required by the AAPCS
+    const uint32_t bottom = (reinterpret_cast<uint32_t>(stack) + 7) & ~7ul;
+    const uint32_t top = (reinterpret_cast<uint32_t>(stack) + stack_size) & ~7ul;
+    uint32_t *words = reinterpret_cast<uint32_t *>(bottom);
+    const size_t word_count = (top - bottom) / sizeof(uint32_t);
+
+    for (size_t i = 0; i < word_count; i++)
+    {
+        words[i] = i < STACK_CANARY_WORDS ? STACK_CANARY : STACK_FILL;
+    }
+
+    // initial frame, as if the task was switched out by PendSV:
+    // - exception frame, popped by the hardware: r0-r3, r12, lr, pc, xpsr
+    // - saved by PendSV_Handler: r3-r11, lr (EXC_RETURN)
+    uint32_t *sp = words + word_count;
+    *(--sp) = 0x01000000ul;                                 // xpsr, thumb bit set
+    *(--sp) = reinterpret_cast<uint32_t>(fn) & ~1ul;        // pc
+    *(--sp) = reinterpret_cast<uint32_t>(task_exit);        // lr, when the task function returns
+    *(--sp) = 0;                                            // r12
+    *(--sp) = 0;                                            // r3
+    *(--sp) = 0;                                            // r2
+    *(--sp) = 0;                                            // r1
+    *(--sp) = reinterpret_cast<uint32_t>(arg);              // r0
+    *(--sp) = EXC_RETURN_THREAD_MSP;                        // lr
+    for (int i = 0; i < 9; i++)
+    {
+        *(--sp) = 0; // r3-r11
+    }
+
+    task->sp = reinterpret_cast<uint32_t>(sp);
+    task->stack = words;
+    task->stack_size = word_count * sizeof(uint32_t);
+    task->name = name;
+    task->priority = priority;
+    task->event = nullptr;
+    task->state = TASK_STATE_READY;
+
+    if (!listed)
+    {
+        task->next = main_task.next;
+        main_task.next = task;
+    }
+    return true;
+}
+
+task_t *task_current(void)
+{
+    return current;
+}
+
+void task_sleep(uint32_t ms)
+{
+    if (!can_switch())
+    {
+        delay(ms);
+        return;
+    }
+
+    current->wake_tick = millis() + ms;
+    current->state = TASK_STATE_SLEEPING;
+    while (current->state != TASK_STATE_READY)
+    {
+        scheduler_yield();
+    }
+}
+
+bool task_wait(task_event_t *event, uint32_t timeout_ms)
+{
+    CORE_ASSERT(event != nullptr, "task_wait: event is nullptr", return false);
+
+    const uint32_t start = millis();
+    for (;;)
+    {
+        if (try_take(event))
+        {
+            return true;
+        }
+
+        if (timeout_ms != TASK_WAIT_FOREVER && (millis() - start) >= timeout_ms)
+        {
+            return false;
+        }
+
+        if (can_switch())
+        {
+            current->event = event;
+            current->wait_forever = timeout_ms == TASK_WAIT_FOREVER;
+            current->wake_tick = start + timeout_ms;
+            current->state = TASK_STATE_WAITING;
+            while (current->state != TASK_STATE_READY)
+            {
+                scheduler_yield();
+            }
+        }
+    }
+}
+
+void task_signal(task_event_t *event)
+{
+    CORE_ASSERT(event != nullptr, "task_signal: event is nullptr", return);
+    __atomic_fetch_add(&event->count, 1, __ATOMIC_RELEASE);
+}
+
+size_t task_get_stack_free(const task_t *task)
+{
+    if (task == nullptr || task->stack == nullptr)
+    {
+        return 0;
+    }
+
+    size_t free = 0;
+    const size_t word_count = task->stack_size / sizeof(uint32_t);
+    for (size_t i = STACK_CANARY_WORDS; i < word_count && task->stack[i] == STACK_FILL; i++)
+    {
+        free += sizeof(uint32_t);
+    }
+    return free;
+}
+
+/**
+ * @brief run deferred work and perform a requested task switch
+ * @param sp stack pointer of the interrupted task, after PendSV_Handler saved its registers
+ * @return stack pointer of the task to resume
+ * @note called by PendSV_Handler
+ */
+extern "C" __attribute__((used)) uint32_t scheduler_switch(uint32_t sp)
+{
+    deferred_run();
+
+    task_t *next = next_task;
+    if (next == nullptr)
+    {
+        return sp;
+    }
+
+    next_task = nullptr;
+    current->sp = sp;
+    check_stack(current);
+
+    current = next;
+    return next->sp;
+}
+
+/**
+ * @brief PendSV handler. replaces the one of the deferred work driver
+ * @note saves the callee-saved registers (and FPU registers, if the task used the FPU) on the stack of
+ *       the interrupted task, so scheduler_switch() can swap stacks
+ */
+extern "C" __attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile(
+#if (__FPU_USED == 1)
+        "tst lr, #0x10          \n"
+        "it eq                  \n"
+        "vpusheq {s16-s31}      \n"
+#endif
+        // r3 keeps the stack 8 byte aligned
+        "push {r3-r11, lr}      \n"
+        "mov r0, sp             \n"
+        "bl scheduler_switch    \n"
+        "mov sp, r0             \n"
+        "pop {r3-r11, lr}       \n"
+#if (__FPU_USED == 1)
+        "tst lr, #0x10          \n"
+        "it eq                  \n"
+        "vpopeq {s16-s31}       \n"
+#endif
+        "bx lr                  \n");
+}
+#endif // CORE_SCHEDULER_ENABLE
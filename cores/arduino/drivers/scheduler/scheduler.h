@@ -0,0 +1,205 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * cooperative task scheduler.
+ *
+ * when CORE_SCHEDULER_ENABLE is defined, yield() switches between tasks. every task has its own stack and
+ * runs until it calls yield(), either directly or through a blocking call like delay(), Usart::flush(),
+ * Usart::write() or adc_await_conversion_completed(). tasks are never preempted, so data shared between
+ * tasks needs no locking as long as no yield() happens in between.
+ *
+ * the code that calls setup() and loop() is the main task. it runs on the main stack and always exists.
+ *
+ * the next task is the ready task with the most urgent priority. tasks with the same priority take turns.
+ * the context switch itself happens in PendSV, which also runs deferred work.
+ *
+ * @note interrupts still run on the stack of the active task, so every task stack needs room for the
+ *       deepest interrupt nesting.
+ */
+
+/**
+ * @brief use task priorities. if 0, all tasks take turns regardless of their priority
+ */
+#ifndef SCHEDULER_USE_PRIORITY
+#define SCHEDULER_USE_PRIORITY 1
+#endif
+
+/**
+ * @brief priority of the main task and default priority of new tasks
+ * @note lower values are more urgent, like NVIC priorities
+ */
+#ifndef SCHEDULER_DEFAULT_PRIORITY
+#define SCHEDULER_DEFAULT_PRIORITY 8
+#endif
+
+/**
+ * @brief sleep (WFI) while no task is ready
+ */
+#ifndef SCHEDULER_IDLE_SLEEP
+#define SCHEDULER_IDLE_SLEEP 1
+#endif
+
+/**
+ * @brief smallest stack a task can be created with, in bytes
+ */
+#define SCHEDULER_MIN_STACK_SIZE 256
+
+/**
+ * @brief timeout value for task_wait() that never expires
+ */
+#define TASK_WAIT_FOREVER 0xFFFFFFFFul
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief task function
+     * @param arg the argument passed to task_create()
+     * @note returning from the function ends the task
+     */
+    typedef void (*task_fn_t)(void *arg);
+
+    /**
+     * @brief task state
+     */
+    typedef enum task_state_t
+    {
+        /**
+         * @brief the task can run
+         */
+        TASK_STATE_READY,
+
+        /**
+         * @brief the task waits in task_sleep()
+         */
+        TASK_STATE_SLEEPING,
+
+        /**
+         * @brief the task waits in task_wait()
+         */
+        TASK_STATE_WAITING,
+
+        /**
+         * @brief the task function returned
+         */
+        TASK_STATE_DONE,
+    } task_state_t;
+
+    /**
+     * @brief a event tasks can wait for
+     * @note counts signals, so a signal is not lost if no task is waiting yet
+     */
+    typedef struct task_event_t
+    {
+        volatile uint32_t count;
+    } task_event_t;
+
+    /**
+     * @brief a task
+     * @note all fields are private. the object must stay valid while the task exists
+     */
+    typedef struct task_t
+    {
+        /**
+         * @brief saved stack pointer, while the task is not running
+         */
+        uint32_t sp;
+
+        /**
+         * @brief stack of the task. nullptr for the main task
+         */
+        uint32_t *stack;
+        size_t stack_size;
+
+        const char *name;
+        uint8_t priority;
+        volatile task_state_t state;
+
+        /**
+         * @brief tick at which a sleeping task wakes, or a wait times out
+         */
+        uint32_t wake_tick;
+
+        /**
+         * @brief the event a waiting task waits for
+         */
+        task_event_t *event;
+        bool wait_forever;
+
+        /**
+         * @brief next task in the list of all tasks
+         */
+        struct task_t *next;
+    } task_t;
+
+#ifdef CORE_SCHEDULER_ENABLE
+    /**
+     * @brief initialize the scheduler
+     * @note called by core_init()
+     */
+    void scheduler_init(void);
+
+    /**
+     * @brief switch to the next ready task, if any
+     * @note called by yield(). does nothing in interrupt context or while interrupts are masked
+     */
+    void scheduler_yield(void);
+
+    /**
+     * @brief create a task. the task first runs on the next call to yield()
+     * @param task the task object. must stay valid while the task exists
+     * @param fn the task function
+     * @param arg argument passed to the task function
+     * @param stack stack of the task. must stay valid while the task exists
+     * @param stack_size size of the stack, in bytes. at least SCHEDULER_MIN_STACK_SIZE
+     * @param priority priority of the task. lower values are more urgent
+     * @param name name of the task, for debugging
+     * @return true if the task was created
+     * @note must not be called from interrupt context
+     */
+    bool task_create(task_t *task, task_fn_t fn, void *arg, void *stack, size_t stack_size, uint8_t priority, const char *name);
+
+    /**
+     * @brief get the running task
+     */
+    task_t *task_current(void);
+
+    /**
+     * @brief let other tasks run for the given time
+     * @param ms time to sleep, in milliseconds
+     * @note must not be called from interrupt context
+     */
+    void task_sleep(uint32_t ms);
+
+    /**
+     * @brief wait until a event is signaled, and consume the signal
+     * @param event the event to wait for
+     * @param timeout_ms maximum time to wait, in milliseconds. TASK_WAIT_FOREVER to wait forever
+     * @return true if the event was signaled, false on timeout
+     * @note must not be called from interrupt context
+     */
+    bool task_wait(task_event_t *event, uint32_t timeout_ms);
+
+    /**
+     * @brief signal a event, waking one waiting task
+     * @param event the event to signal
+     * @note safe to call from any context
+     */
+    void task_signal(task_event_t *event);
+
+    /**
+     * @brief get the number of stack bytes a task never used
+     * @param task the task
+     * @return unused bytes, or 0 for the main task
+     */
+    size_t task_get_stack_free(const task_t *task);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,193 @@
+#include "soft_timer.h"
+#include "soft_timer_wheel.h"
+#include "../../core_critical.h"
+#include "../../core_debug.h"
+
+static SoftTimerWheel<SOFT_TIMER_WHEEL_SIZE> wheel;
+
+/**
+ * @brief current tick, as seen by soft_timer_tick()
+ */
+static volatile uint32_t current_tick = 0;
+
+/**
+ * @brief timers waiting for yield(), in the order they expired
+ */
+static soft_timer_t *pending_head = nullptr;
+static soft_timer_t *pending_tail = nullptr;
+
+/**
+ * @brief append a timer to the pending list, if not already in it
+ * @note interrupts must be masked
+ */
+static void pending_append(soft_timer_t *timer)
+{
+    if (timer->pending)
+    {
+        return;
+    }
+
+    timer->pending = true;
+    timer->pending_next = nullptr;
+    timer->pending_prev = pending_tail;
+    if (pending_tail != nullptr)
+    {
+        pending_tail->pending_next = timer;
+    }
+    else
+    {
+        pending_head = timer;
+    }
+    pending_tail = timer;
+}
+
+/**
+ * @brief remove a timer from the pending list, if in it
+ * @note interrupts must be masked
+ */
+static void pending_remove(soft_timer_t *timer)
+{
+    if (!timer->pending)
+    {
+        return;
+    }
+
+    if (timer->pending_prev != nullptr)
+    {
+        timer->pending_prev->pending_next = timer->pending_next;
+    }
+    else
+    {
+        pending_head = timer->pending_next;
+    }
+
+    if (timer->pending_next != nullptr)
+    {
+        timer->pending_next->pending_prev = timer->pending_prev;
+    }
+    else
+    {
+        pending_tail = timer->pending_prev;
+    }
+
+    timer->pending_next = nullptr;
+    timer->pending_prev = nullptr;
+    timer->pending = false;
+}
+
+void soft_timer_init(soft_timer_t *timer, soft_timer_callback_t callback, void *arg, soft_timer_context_t context)
+{
+    CORE_ASSERT(timer != nullptr, "soft_timer_init: timer is nullptr", return);
+    CORE_ASSERT(callback != nullptr, "soft_timer_init: callback is nullptr", return);
+    CORE_ASSERT(!timer->active && !timer->pending, "soft_timer_init: timer is active", return);
+
+    *timer = {};
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->context = context;
+}
+
+void soft_timer_start(soft_timer_t *timer, uint32_t delay_ms, uint32_t period_ms)
+{
+    CORE_ASSERT(timer != nullptr && timer->callback != nullptr, "soft_timer_start: timer not initialized", return);
+
+    // the current tick was already processed
+    if (delay_ms == 0)
+    {
+        delay_ms = 1;
+    }
+
+    CORE_CRITICAL_SECTION(0, {
+        if (timer->active)
+        {
+            wheel.remove(timer);
+        }
+
+        timer->period = period_ms;
+        timer->active = true;
+        wheel.insert(timer, current_tick + delay_ms);
+    });
+}
+
+void soft_timer_stop(soft_timer_t *timer)
+{
+    CORE_ASSERT(timer != nullptr, "soft_timer_stop: timer is nullptr", return);
+
+    CORE_CRITICAL_SECTION(0, {
+        if (timer->active)
+        {
+            wheel.remove(timer);
+            timer->active = false;
+        }
+
+        // cancel a callback waiting for yield(), so the timer is no longer referenced
+        pending_remove(timer);
+    });
+}
+
+void soft_timer_tick(uint32_t now)
+{
+    current_tick = now;
+
+    for (;;)
+    {
+        soft_timer_t *timer;
+        CORE_CRITICAL_SECTION(0, {
+            timer = wheel.pop_expired(now);
+            if (timer != nullptr)
+            {
+                if (timer->period != 0)
+                {
+                    wheel.insert(timer, now + timer->period);
+                }
+                else
+                {
+                    timer->active = false;
+                }
+
+                if (timer->context == SOFT_TIMER_CONTEXT_YIELD)
+                {
+                    pending_append(timer);
+                }
+            }
+        });
+
+        if (timer == nullptr)
+        {
+            break;
+        }
+
+        // callbacks may start and stop timers, including their own
+        if (timer->context == SOFT_TIMER_CONTEXT_ISR)
+        {
+            timer->callback(timer->arg);
+        }
+    }
+}
+
+void soft_timer_run_pending(void)
+{
+    for (;;)
+    {
+        soft_timer_t *timer;
+        CORE_CRITICAL_SECTION(0, {
+            timer = pending_head;
+            if (timer != nullptr)
+            {
+                pending_remove(timer);
+            }
+        });
+
+        if (timer == nullptr)
+        {
+            break;
+        }
+
+        timer->callback(timer->arg);
+    }
+}
+
+bool soft_timer_has_pending(void)
+{
+    return pending_head != nullptr;
+}
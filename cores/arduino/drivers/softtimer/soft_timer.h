@@ -0,0 +1,144 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * software timers.
+ *
+ * one-shot and periodic timers with millisecond resolution, driven by the systick interrupt.
+ * timers are kept in a hashed timing wheel of SOFT_TIMER_WHEEL_SIZE buckets, indexed by the expiry tick.
+ * starting and stopping a timer is O(1). every tick only checks the timers in a single bucket.
+ *
+ * callbacks run either directly in the systick interrupt, or later in yield() (e.g. while loop() calls delay()).
+ * timer objects are owned by the caller and must stay valid while the timer is active.
+ */
+
+/**
+ * @brief number of buckets in the timing wheel
+ * @note must be a power of two. more buckets means fewer timers to check per tick
+ */
+#ifndef SOFT_TIMER_WHEEL_SIZE
+#define SOFT_TIMER_WHEEL_SIZE 32
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief software timer callback
+     * @param arg the argument passed to soft_timer_init()
+     */
+    typedef void (*soft_timer_callback_t)(void *arg);
+
+    /**
+     * @brief where the callback of a software timer runs
+     */
+    typedef enum soft_timer_context_t
+    {
+        /**
+         * @brief in the systick interrupt. keep the callback short
+         */
+        SOFT_TIMER_CONTEXT_ISR,
+
+        /**
+         * @brief in the next call to yield(). the callback may take longer, but runs later
+         * @note if the timer expires again before yield() runs, the callback is only called once
+         */
+        SOFT_TIMER_CONTEXT_YIELD,
+    } soft_timer_context_t;
+
+    /**
+     * @brief a software timer
+     * @note initialize using soft_timer_init(). all fields are private
+     */
+    typedef struct soft_timer_t
+    {
+        soft_timer_callback_t callback;
+        void *arg;
+        soft_timer_context_t context;
+
+        /**
+         * @brief tick the timer expires at
+         */
+        uint32_t expires;
+
+        /**
+         * @brief period in ms, 0 for one-shot timers
+         */
+        uint32_t period;
+
+        /**
+         * @brief links in the wheel bucket
+         */
+        struct soft_timer_t *next;
+        struct soft_timer_t *prev;
+
+        /**
+         * @brief links in the list of timers waiting for yield()
+         */
+        struct soft_timer_t *pending_next;
+        struct soft_timer_t *pending_prev;
+
+        volatile bool active;
+        volatile bool pending;
+    } soft_timer_t;
+
+    /**
+     * @brief initialize a software timer
+     * @param timer the timer
+     * @param callback function to call when the timer expires
+     * @param arg argument passed to the callback
+     * @param context where the callback runs
+     * @note the timer must not be active or waiting for yield(). stop it first
+     */
+    void soft_timer_init(soft_timer_t *timer, soft_timer_callback_t callback, void *arg, soft_timer_context_t context);
+
+    /**
+     * @brief start a software timer
+     * @param timer the timer
+     * @param delay_ms time until the timer expires first, in ms. a delay of 0 expires on the next tick
+     * @param period_ms period of the timer, in ms. 0 for a one-shot timer
+     * @note restarts the timer if it is already active
+     * @note safe to call from any context, including from a timer callback
+     */
+    void soft_timer_start(soft_timer_t *timer, uint32_t delay_ms, uint32_t period_ms);
+
+    /**
+     * @brief stop a software timer
+     * @param timer the timer
+     * @note a callback waiting for yield() is cancelled as well. once stopped, the timer may be freed
+     */
+    void soft_timer_stop(soft_timer_t *timer);
+
+    /**
+     * @brief check if a software timer is active
+     */
+    static inline bool soft_timer_is_active(const soft_timer_t *timer)
+    {
+        return timer->active;
+    }
+
+    /**
+     * @brief process the timers expiring at a tick
+     * @param now the current tick
+     * @note called by the systick interrupt, once every tick
+     */
+    void soft_timer_tick(uint32_t now);
+
+    /**
+     * @brief run the callbacks of expired timers with SOFT_TIMER_CONTEXT_YIELD
+     * @note called by yield()
+     */
+    void soft_timer_run_pending(void);
+
+    /**
+     * @brief check if any expired timers wait for yield()
+     * @note only a snapshot, unless called with interrupts masked
+     */
+    bool soft_timer_has_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
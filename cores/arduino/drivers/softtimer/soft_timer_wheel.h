@@ -0,0 +1,81 @@
+#pragma once
+#include "soft_timer.h"
+
+/**
+ * hashed timing wheel of software timers.
+ *
+ * a timer is linked into the bucket (expires % N). on every tick, only the bucket of that tick is checked,
+ * and timers of later rounds in the same bucket are skipped. inserting and removing are O(1).
+ *
+ * the wheel itself does no locking. callers must prevent concurrent access.
+ */
+template <uint32_t N>
+class SoftTimerWheel
+{
+    static_assert(N >= 1 && (N & (N - 1)) == 0, "SoftTimerWheel size must be a power of two");
+
+public:
+    /**
+     * @brief link a timer into the wheel
+     * @param timer the timer. must not be linked already
+     * @param expires tick the timer expires at
+     */
+    void insert(soft_timer_t *timer, const uint32_t expires)
+    {
+        soft_timer_t *&bucket = buckets[expires & (N - 1)];
+        timer->expires = expires;
+        timer->prev = nullptr;
+        timer->next = bucket;
+        if (bucket != nullptr)
+        {
+            bucket->prev = timer;
+        }
+        bucket = timer;
+    }
+
+    /**
+     * @brief unlink a timer from the wheel
+     * @param timer the timer. must be linked
+     */
+    void remove(soft_timer_t *timer)
+    {
+        if (timer->prev != nullptr)
+        {
+            timer->prev->next = timer->next;
+        }
+        else
+        {
+            buckets[timer->expires & (N - 1)] = timer->next;
+        }
+
+        if (timer->next != nullptr)
+        {
+            timer->next->prev = timer->prev;
+        }
+
+        timer->next = nullptr;
+        timer->prev = nullptr;
+    }
+
+    /**
+     * @brief unlink and return a timer that expires at a tick
+     * @param now the tick
+     * @return the timer, or nullptr if no more timers expire at this tick
+     */
+    soft_timer_t *pop_expired(const uint32_t now)
+    {
+        for (soft_timer_t *timer = buckets[now & (N - 1)]; timer != nullptr; timer = timer->next)
+        {
+            if (timer->expires == now)
+            {
+                remove(timer);
+                return timer;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    soft_timer_t *buckets[N] = {};
+};
@@ -0,0 +1,162 @@
+#include "sysclock_change.h"
+#include "sysclock_util.h"
+#include "systick.h"
+#include "../timera/timera_util.h"
+#include "../../core_critical.h"
+#include "../../core_debug.h"
+
+/**
+ * @brief registered clock change listeners
+ */
+static sysclock_listener_t *listeners = nullptr;
+
+void sysclock_add_listener(sysclock_listener_t *listener)
+{
+    CORE_ASSERT(listener != nullptr, "sysclock_add_listener: listener is null", return);
+
+    CORE_CRITICAL_SECTION(0, {
+        bool registered = false;
+        for (sysclock_listener_t *l = listeners; l != nullptr; l = l->next)
+        {
+            if (l == listener)
+            {
+                registered = true;
+                break;
+            }
+        }
+
+        if (!registered)
+        {
+            listener->next = listeners;
+            listeners = listener;
+        }
+    });
+}
+
+void sysclock_remove_listener(sysclock_listener_t *listener)
+{
+    CORE_CRITICAL_SECTION(0, {
+        for (sysclock_listener_t **l = &listeners; *l != nullptr; l = &(*l)->next)
+        {
+            if (*l == listener)
+            {
+                *l = listener->next;
+                listener->next = nullptr;
+                break;
+            }
+        }
+    });
+}
+
+void sysclock_change(sysclock_change_fn_t change, void *arg)
+{
+    CORE_ASSERT(change != nullptr, "sysclock_change: change function is null", return);
+    CORE_ASSERT(__get_IPSR() == 0, "sysclock_change: called from interrupt context", return);
+
+    // let drivers finish ongoing transfers at the old clocks.
+    // listeners must not add or remove listeners in their callbacks
+    for (sysclock_listener_t *l = listeners; l != nullptr; l = l->next)
+    {
+        if (l->pre_change != nullptr)
+        {
+            l->pre_change(l->arg);
+        }
+    }
+
+    CORE_CRITICAL_SECTION(0, {
+        const system_clock_frequencies_t old_clocks = SYSTEM_CLOCK_FREQUENCIES;
+
+        change(arg);
+        update_system_clock_frequencies();
+
+        // core timebase and TimerA units
+        systick_update_clock(SYSTEM_CLOCK_FREQUENCIES.hclk);
+        timera_update_clock(&old_clocks);
+
+        for (sysclock_listener_t *l = listeners; l != nullptr; l = l->next)
+        {
+            if (l->post_change != nullptr)
+            {
+                l->post_change(l->arg, &old_clocks);
+            }
+        }
+    });
+
+    CORE_DEBUG_PRINTF("sysclock_change: HCLK=%lu PCLK1=%lu\n", SYSTEM_CLOCK_FREQUENCIES.hclk, SYSTEM_CLOCK_FREQUENCIES.pclk1);
+}
+
+static void change_dividers(void *arg)
+{
+    const stc_clk_sysclk_cfg_t *dividers = static_cast<const stc_clk_sysclk_cfg_t *>(arg);
+    const uint32_t old_hclk = SYSTEM_CLOCK_FREQUENCIES.hclk;
+    const uint32_t new_hclk = SYSTEM_CLOCK_FREQUENCIES.system / div_factor_to_n(dividers->enHclkDiv);
+
+    const uint32_t old_flash_wait_cycles = sysclock_get_flash_wait_cycles(old_hclk);
+    const uint32_t new_flash_wait_cycles = sysclock_get_flash_wait_cycles(new_hclk);
+    const uint32_t old_sram_wait_cycles = sysclock_get_sram_wait_cycles(old_hclk);
+    const uint32_t new_sram_wait_cycles = sysclock_get_sram_wait_cycles(new_hclk);
+
+    // flash and SRAM must never be accessed with less wait cycles than required, so raise them before the switch
+    // and lower them after
+    if (new_flash_wait_cycles > old_flash_wait_cycles)
+    {
+        sysclock_set_flash_wait_cycles(new_flash_wait_cycles);
+    }
+    if (new_sram_wait_cycles > old_sram_wait_cycles)
+    {
+        sysclock_set_sram_wait_cycles(new_sram_wait_cycles);
+    }
+
+    sysclock_set_clock_dividers(dividers);
+
+    if (new_flash_wait_cycles < old_flash_wait_cycles)
+    {
+        sysclock_set_flash_wait_cycles(new_flash_wait_cycles);
+    }
+    if (new_sram_wait_cycles < old_sram_wait_cycles)
+    {
+        sysclock_set_sram_wait_cycles(new_sram_wait_cycles);
+    }
+}
+
+void sysclock_change_dividers(const stc_clk_sysclk_cfg_t *dividers)
+{
+    CORE_ASSERT(dividers != nullptr, "sysclock_change_dividers: dividers is null", return);
+    sysclock_change(change_dividers, const_cast<stc_clk_sysclk_cfg_t *>(dividers));
+}
+
+uint32_t sysclock_get_flash_wait_cycles(uint32_t hclk)
+{
+    return sysclock_plan_flash_wait_cycles(hclk);
+}
+
+void sysclock_set_flash_wait_cycles(uint32_t wait_cycles)
+{
+    static const uint32_t latencies[] = {
+        EFM_LATENCY_0,
+        EFM_LATENCY_1,
+        EFM_LATENCY_2,
+        EFM_LATENCY_3,
+        EFM_LATENCY_4,
+        EFM_LATENCY_5,
+    };
+    CORE_ASSERT(wait_cycles < (sizeof(latencies) / sizeof(latencies[0])), "sysclock_set_flash_wait_cycles: invalid wait cycles", return);
+
+    EFM_Unlock();
+    EFM_SetLatency(latencies[wait_cycles]);
+    EFM_Lock();
+}
+
+uint32_t sysclock_get_sram_wait_cycles(uint32_t hclk)
+{
+    return sysclock_plan_sram_wait_cycles(hclk);
+}
+
+void sysclock_set_sram_wait_cycles(uint32_t wait_cycles)
+{
+    CORE_ASSERT(wait_cycles <= 1, "sysclock_set_sram_wait_cycles: invalid wait cycles", return);
+
+    // same mapping as sysclock_apply_plan()
+    const en_sram_rw_cycle_t cycles = wait_cycles == 0 ? SramCycle1 : SramCycle2;
+    sysclock_configure_sram_wait_cycles(cycles, cycles);
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "sysclock.h"
+#include <hc32_ddl.h>
+
+/**
+ * runtime clock changes.
+ *
+ * the core configures the clocks once in core_init(), using core_hook_sysclock_init().
+ * sysclock_change() allows switching the clocks (e.g. MPLL and dividers) at runtime. drivers that derive their
+ * timing from the clocks register a listener, and are notified before and after the change:
+ * - pre_change runs before the clocks change, with interrupts enabled. use it to finish ongoing transfers.
+ * - post_change runs after the clocks changed, with interrupts masked. use it to recompute dividers.
+ *
+ * Usart, SPI and Timer0 register themselves while they are active.
+ * SysTick and the TimerA units (PWM, tone and input capture) are updated by the core.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief clock change listener
+     * @note the listener must stay valid until it is removed
+     */
+    typedef struct sysclock_listener_t
+    {
+        /**
+         * @brief called before the clocks change. may be NULL
+         * @param arg the listener argument
+         * @note runs in thread mode, with interrupts enabled
+         */
+        void (*pre_change)(void *arg);
+
+        /**
+         * @brief called after the clocks changed. may be NULL
+         * @param arg the listener argument
+         * @param old_clocks the clock frequencies before the change
+         * @note SYSTEM_CLOCK_FREQUENCIES already holds the new clock frequencies
+         * @note runs with interrupts masked, so it must not block
+         */
+        void (*post_change)(void *arg, const system_clock_frequencies_t *old_clocks);
+
+        /**
+         * @brief argument passed to the callbacks
+         */
+        void *arg;
+
+        /**
+         * @brief next listener in the list
+         * @note managed by sysclock_add_listener() and sysclock_remove_listener()
+         */
+        struct sysclock_listener_t *next;
+    } sysclock_listener_t;
+
+    /**
+     * @brief function that changes the clock configuration
+     * @param arg the argument passed to sysclock_change()
+     * @note runs with interrupts masked. use the functions in sysclock_util.h
+     */
+    typedef void (*sysclock_change_fn_t)(void *arg);
+
+    /**
+     * @brief register a clock change listener
+     * @param listener the listener to add
+     * @note adding a listener that is already registered does nothing
+     */
+    void sysclock_add_listener(sysclock_listener_t *listener);
+
+    /**
+     * @brief remove a clock change listener
+     * @param listener the listener to remove
+     * @note removing a listener that is not registered does nothing
+     */
+    void sysclock_remove_listener(sysclock_listener_t *listener);
+
+    /**
+     * @brief change the clock configuration at runtime
+     * @param change function that changes the clocks
+     * @param arg argument passed to the change function
+     *
+     * @note
+     * the sequence is:
+     * 1. call pre_change of all listeners
+     * 2. mask interrupts
+     * 3. call the change function
+     * 4. update SYSTEM_CLOCK_FREQUENCIES, SysTick and the TimerA units
+     * 5. call post_change of all listeners
+     * 6. restore interrupts
+     *
+     * @note the change function is responsible for the flash and SRAM wait cycles and the power mode.
+     *       raise them before increasing the clocks, and lower them after decreasing the clocks.
+     * @note must be called from thread mode
+     */
+    void sysclock_change(sysclock_change_fn_t change, void *arg);
+
+    /**
+     * @brief change the HCLK, PCLKn and EXCLK dividers at runtime
+     * @param dividers the new clock dividers
+     * @note the system clock source stays the same
+     * @note updates the flash and SRAM wait cycles for the new HCLK
+     */
+    void sysclock_change_dividers(const stc_clk_sysclk_cfg_t *dividers);
+
+    /**
+     * @brief get the number of flash wait cycles required for a HCLK frequency
+     * @param hclk the HCLK frequency, in Hz
+     * @return the number of wait cycles [0, 5]
+     * @note refer to HC32F460 user manual, Section 7.4, Table 7-1
+     */
+    uint32_t sysclock_get_flash_wait_cycles(uint32_t hclk);
+
+    /**
+     * @brief set the flash wait cycles
+     * @param wait_cycles the number of wait cycles [0, 5]
+     */
+    void sysclock_set_flash_wait_cycles(uint32_t wait_cycles);
+
+    /**
+     * @brief get the number of SRAM wait cycles required for a HCLK frequency
+     * @param hclk the HCLK frequency, in Hz
+     * @return the number of wait cycles [0, 1]
+     * @note refer to HC32F460 user manual, Section 8.1, Table 8-1
+     */
+    uint32_t sysclock_get_sram_wait_cycles(uint32_t hclk);
+
+    /**
+     * @brief set the SRAM read and write wait cycles
+     * @param wait_cycles the number of wait cycles [0, 1]
+     */
+    void sysclock_set_sram_wait_cycles(uint32_t wait_cycles);
+
+#ifdef __cplusplus
+}
+#endif
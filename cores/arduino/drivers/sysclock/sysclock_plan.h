@@ -0,0 +1,331 @@
+#pragma once
+#include "sysclock.h"
+#include <stdint.h>
+
+/**
+ * compile-time clock tree planner.
+ *
+ * given the XTAL frequency and the target clock frequencies, sysclock_plan() computes a legal clock
+ * configuration: the MPLL settings (M, N, P), the HCLK, PCLKn and EXCLK dividers, and the flash and SRAM wait
+ * cycles. it is constexpr, so the plan is computed by the compiler and checked using static_assert.
+ *
+ * the targets are upper bounds. the planner chooses the highest HCLK that does not exceed the HCLK target,
+ * preferring the lowest system clock (i.e. the smallest HCLK divider) to reach it. for the chosen system clock,
+ * each other clock gets the smallest divider that keeps it within its target and the rules of the clock tree.
+ *
+ * use SYSCLOCK_PLAN_INIT_HOOK() in sysclock_util.h to turn a plan into a core_hook_sysclock_init() implementation.
+ *
+ * this header does not depend on the DDL.
+ */
+
+//
+// clock tree limits
+// (refer to HC32F460 user manual, Section 4.4, Table 4-1 and Section 4.11.15)
+//
+
+constexpr uint32_t SYSCLOCK_MAX_SYSTEM = 200000000;
+constexpr uint32_t SYSCLOCK_MAX_HCLK = 200000000;
+constexpr uint32_t SYSCLOCK_MAX_PCLK0 = 200000000;
+constexpr uint32_t SYSCLOCK_MAX_PCLK1 = 100000000;
+constexpr uint32_t SYSCLOCK_MAX_PCLK2 = 60000000;
+constexpr uint32_t SYSCLOCK_MAX_PCLK3 = 50000000;
+constexpr uint32_t SYSCLOCK_MAX_PCLK4 = 100000000;
+constexpr uint32_t SYSCLOCK_MAX_EXCLK = 100000000;
+
+constexpr uint32_t SYSCLOCK_MIN_XTAL = 4000000;
+constexpr uint32_t SYSCLOCK_MAX_XTAL = 25000000;
+
+constexpr uint32_t SYSCLOCK_MPLL_MIN_M = 1;
+constexpr uint32_t SYSCLOCK_MPLL_MAX_M = 24;
+constexpr uint32_t SYSCLOCK_MPLL_MIN_N = 20;
+constexpr uint32_t SYSCLOCK_MPLL_MAX_N = 480;
+constexpr uint32_t SYSCLOCK_MPLL_MIN_P = 2;
+constexpr uint32_t SYSCLOCK_MPLL_MAX_P = 16;
+constexpr uint32_t SYSCLOCK_MPLL_MIN_VCO_IN = 1000000;
+constexpr uint32_t SYSCLOCK_MPLL_MAX_VCO_IN = 25000000;
+constexpr uint32_t SYSCLOCK_MPLL_MIN_VCO_OUT = 240000000;
+constexpr uint32_t SYSCLOCK_MPLL_MAX_VCO_OUT = 480000000;
+
+/**
+ * @brief largest clock divider, as power of two (1 << 6 = 64)
+ */
+constexpr uint8_t SYSCLOCK_MAX_DIV_SHIFT = 6;
+
+/**
+ * @brief target clock frequencies, in Hz
+ * @note each target is a upper bound. 0 means as fast as the clock tree allows
+ */
+struct sysclock_plan_targets_t
+{
+    uint32_t hclk = 0;
+    uint32_t pclk0 = 0;
+    uint32_t pclk1 = 0;
+    uint32_t pclk2 = 0;
+    uint32_t pclk3 = 0;
+    uint32_t pclk4 = 0;
+    uint32_t exclk = 0;
+};
+
+/**
+ * @brief a clock configuration computed by sysclock_plan()
+ */
+struct sysclock_plan_t
+{
+    /**
+     * @brief was a legal configuration found?
+     * @note all other fields are only meaningful if true
+     */
+    bool valid = false;
+
+    /**
+     * @brief MPLL input clock (XTAL) frequency, in Hz
+     */
+    uint32_t input_clock = 0;
+
+    /**
+     * @brief MPLL settings. MPLL-P is the system clock
+     * @note Q and R are set equal to P
+     */
+    uint32_t mpll_m = 0;
+    uint32_t mpll_n = 0;
+    uint32_t mpll_p = 0;
+    uint32_t mpll_q = 0;
+    uint32_t mpll_r = 0;
+
+    /**
+     * @brief clock dividers, as power of two (e.g. 2 means divide by 4)
+     * @note equal to the en_clk_sysclk_div_factor_t values of the DDL
+     */
+    uint8_t hclk_div = 0;
+    uint8_t pclk0_div = 0;
+    uint8_t pclk1_div = 0;
+    uint8_t pclk2_div = 0;
+    uint8_t pclk3_div = 0;
+    uint8_t pclk4_div = 0;
+    uint8_t exclk_div = 0;
+
+    /**
+     * @brief resulting clock frequencies
+     */
+    system_clock_frequencies_t clocks = {};
+
+    /**
+     * @brief flash wait cycles for HCLK [0, 5]
+     */
+    uint32_t flash_wait_cycles = 0;
+
+    /**
+     * @brief SRAM read and write wait cycles for HCLK [0, 1]
+     */
+    uint32_t sram_wait_cycles = 0;
+};
+
+/**
+ * @brief get the number of flash wait cycles required for a HCLK frequency
+ * @param hclk the HCLK frequency, in Hz
+ * @return the number of wait cycles [0, 5]
+ * @note refer to HC32F460 user manual, Section 7.4, Table 7-1
+ */
+constexpr uint32_t sysclock_plan_flash_wait_cycles(const uint32_t hclk)
+{
+    return hclk <= 33000000    ? 0
+           : hclk <= 66000000  ? 1
+           : hclk <= 99000000  ? 2
+           : hclk <= 132000000 ? 3
+           : hclk <= 168000000 ? 4
+                               : 5;
+}
+
+/**
+ * @brief get the number of SRAM wait cycles required for a HCLK frequency
+ * @param hclk the HCLK frequency, in Hz
+ * @return the number of wait cycles [0, 1]
+ * @note refer to HC32F460 user manual, Section 8.1, Table 8-1
+ */
+constexpr uint32_t sysclock_plan_sram_wait_cycles(const uint32_t hclk)
+{
+    return hclk <= 100000000 ? 0 : 1;
+}
+
+/**
+ * @brief resolve a target to its effective upper bound
+ * @param target the target frequency, 0 for no target
+ * @param limit the maximum frequency of the clock
+ */
+constexpr uint32_t sysclock_plan_bound(const uint32_t target, const uint32_t limit)
+{
+    return (target == 0 || target > limit) ? limit : target;
+}
+
+/**
+ * @brief find the smallest divider that keeps a clock within its bound
+ * @param system the system clock frequency
+ * @param bound the upper bound of the clock
+ * @param min_div the smallest allowed divider, as power of two
+ * @return the divider as power of two, or SYSCLOCK_MAX_DIV_SHIFT + 1 if none fits
+ */
+constexpr uint8_t sysclock_plan_find_div(const uint32_t system, const uint32_t bound, const uint8_t min_div)
+{
+    uint8_t div = min_div;
+    while (div <= SYSCLOCK_MAX_DIV_SHIFT && (system >> div) > bound)
+    {
+        div++;
+    }
+    return div;
+}
+
+/**
+ * @brief compute the dividers for a system clock, and fill in the plan
+ * @param plan the plan, with the system clock and HCLK divider set
+ * @param targets the target frequencies
+ * @return true if all dividers are legal
+ *
+ * @note
+ * rules as per Section 4.4, Note 1 of the HC32F460 user manual. since all clocks are powers of two of the system
+ * clock, frequency rules become divider rules:
+ * - PCLK1, PCLK3, PCLK4 <= HCLK
+ * - HCLK / EXCLK in { 2, 4, 8, 16, 32 }
+ * - PCLK1, PCLK3 <= PCLK0
+ * - PCLK2 / PCLK4 in { 1/4, 1/2, 1, 2, 4, 8 }
+ */
+constexpr bool sysclock_plan_dividers(sysclock_plan_t &plan, const sysclock_plan_targets_t &targets)
+{
+    const uint32_t system = plan.clocks.system;
+
+    plan.pclk0_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.pclk0, SYSCLOCK_MAX_PCLK0), 0);
+
+    const uint8_t min_pclk1_3 = plan.hclk_div > plan.pclk0_div ? plan.hclk_div : plan.pclk0_div;
+    plan.pclk1_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.pclk1, SYSCLOCK_MAX_PCLK1), min_pclk1_3);
+    plan.pclk3_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.pclk3, SYSCLOCK_MAX_PCLK3), min_pclk1_3);
+    plan.pclk4_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.pclk4, SYSCLOCK_MAX_PCLK4), plan.hclk_div);
+    plan.pclk2_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.pclk2, SYSCLOCK_MAX_PCLK2), 0);
+    plan.exclk_div = sysclock_plan_find_div(system, sysclock_plan_bound(targets.exclk, SYSCLOCK_MAX_EXCLK), plan.hclk_div + 1);
+
+    // PCLK2 / PCLK4 = 2^(pclk4_div - pclk2_div) must be in [1/4, 8]. slow down the faster clock to fit
+    if (plan.pclk4_div + 2 < plan.pclk2_div)
+    {
+        plan.pclk4_div = plan.pclk2_div - 2;
+    }
+    if (plan.pclk4_div > plan.pclk2_div + 3)
+    {
+        plan.pclk2_div = plan.pclk4_div - 3;
+    }
+
+    if (plan.pclk0_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.pclk1_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.pclk2_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.pclk3_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.pclk4_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.exclk_div > SYSCLOCK_MAX_DIV_SHIFT ||
+        plan.exclk_div > plan.hclk_div + 5)
+    {
+        return false;
+    }
+
+    plan.clocks.hclk = system >> plan.hclk_div;
+    plan.clocks.pclk0 = system >> plan.pclk0_div;
+    plan.clocks.pclk1 = system >> plan.pclk1_div;
+    plan.clocks.pclk2 = system >> plan.pclk2_div;
+    plan.clocks.pclk3 = system >> plan.pclk3_div;
+    plan.clocks.pclk4 = system >> plan.pclk4_div;
+    plan.clocks.exclk = system >> plan.exclk_div;
+    return true;
+}
+
+/**
+ * @brief plan a clock configuration with the MPLL clocked by XTAL
+ * @param xtal the XTAL frequency, in Hz [4 MHz, 25 MHz]
+ * @param targets the target frequencies
+ * @return the plan. check plan.valid
+ *
+ * @note
+ * e.g. 'constexpr sysclock_plan_t plan = sysclock_plan(8000000, {.hclk = 200000000});'
+ * gives a 200 MHz system clock, with every other clock at its maximum.
+ */
+constexpr sysclock_plan_t sysclock_plan(const uint32_t xtal, const sysclock_plan_targets_t &targets)
+{
+    sysclock_plan_t best;
+    if (xtal < SYSCLOCK_MIN_XTAL || xtal > SYSCLOCK_MAX_XTAL)
+    {
+        return best;
+    }
+
+    const uint32_t hclk_bound = sysclock_plan_bound(targets.hclk, SYSCLOCK_MAX_HCLK);
+
+    // every other clock must reach its target with the largest divider, which limits the system clock
+    uint64_t peripheral_bound = SYSCLOCK_MAX_SYSTEM;
+    const uint32_t peripheral_bounds[] = {
+        sysclock_plan_bound(targets.pclk0, SYSCLOCK_MAX_PCLK0),
+        sysclock_plan_bound(targets.pclk1, SYSCLOCK_MAX_PCLK1),
+        sysclock_plan_bound(targets.pclk2, SYSCLOCK_MAX_PCLK2),
+        sysclock_plan_bound(targets.pclk3, SYSCLOCK_MAX_PCLK3),
+        sysclock_plan_bound(targets.pclk4, SYSCLOCK_MAX_PCLK4),
+        sysclock_plan_bound(targets.exclk, SYSCLOCK_MAX_EXCLK),
+    };
+    for (const uint32_t bound : peripheral_bounds)
+    {
+        const uint64_t system_bound = static_cast<uint64_t>(bound) << SYSCLOCK_MAX_DIV_SHIFT;
+        if (system_bound < peripheral_bound)
+        {
+            peripheral_bound = system_bound;
+        }
+    }
+    for (uint32_t m = SYSCLOCK_MPLL_MIN_M; m <= SYSCLOCK_MPLL_MAX_M; m++)
+    {
+        // VCO_in = XTAL / M, compared without rounding
+        if (xtal < SYSCLOCK_MPLL_MIN_VCO_IN * m || xtal > SYSCLOCK_MPLL_MAX_VCO_IN * m)
+        {
+            continue;
+        }
+
+        for (uint32_t p = SYSCLOCK_MPLL_MIN_P; p <= SYSCLOCK_MPLL_MAX_P; p++)
+        {
+            for (uint8_t hclk_div = 0; hclk_div <= SYSCLOCK_MAX_DIV_SHIFT; hclk_div++)
+            {
+                // highest N that keeps the system clock within the targets
+                const uint64_t system_bound = static_cast<uint64_t>(hclk_bound) << hclk_div;
+                uint64_t n = ((system_bound < peripheral_bound ? system_bound : peripheral_bound) * m * p) / xtal;
+                if (n > SYSCLOCK_MPLL_MAX_N)
+                {
+                    n = SYSCLOCK_MPLL_MAX_N;
+                }
+
+                // VCO_out = (XTAL / M) * N, compared without rounding
+                const uint64_t vco_out_m = static_cast<uint64_t>(xtal) * n;
+                if (n < SYSCLOCK_MPLL_MIN_N ||
+                    vco_out_m < static_cast<uint64_t>(SYSCLOCK_MPLL_MIN_VCO_OUT) * m ||
+                    vco_out_m > static_cast<uint64_t>(SYSCLOCK_MPLL_MAX_VCO_OUT) * m)
+                {
+                    continue;
+                }
+
+                sysclock_plan_t plan;
+                plan.input_clock = xtal;
+                plan.mpll_m = m;
+                plan.mpll_n = static_cast<uint32_t>(n);
+                plan.mpll_p = p;
+                plan.mpll_q = p;
+                plan.mpll_r = p;
+                plan.hclk_div = hclk_div;
+                plan.clocks.system = static_cast<uint32_t>(vco_out_m / (m * p));
+                if (!sysclock_plan_dividers(plan, targets))
+                {
+                    continue;
+                }
+
+                // prefer the highest HCLK, then the lowest system clock
+                if (!best.valid ||
+                    plan.clocks.hclk > best.clocks.hclk ||
+                    (plan.clocks.hclk == best.clocks.hclk && plan.clocks.system < best.clocks.system))
+                {
+                    plan.valid = true;
+                    best = plan;
+                }
+            }
+        }
+    }
+
+    best.flash_wait_cycles = sysclock_plan_flash_wait_cycles(best.clocks.hclk);
+    best.sram_wait_cycles = sysclock_plan_sram_wait_cycles(best.clocks.hclk);
+    return best;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "sysclock.h"
+#include "sysclock_change.h"
 #include <hc32_ddl.h>
 
 //
@@ -226,6 +227,8 @@ inline void sysclock_restore_default_clocks()
 
 
 #ifdef __cplusplus
+#include "sysclock_plan.h"
+
 /**
  * @brief en_clk_sysclk_div_factor to integer division factor
  * @param div_factor The clock divider factor
@@ -375,4 +378,71 @@ constexpr void assert_mpll_config_valid()
   static_assert(vco_out >= 240000000 && vco_out <= 480000000, "MPLL VCO output frequency must be in range [240MHz, 480MHz].");
 }
 
+//
+// clock tree planner
+//
+
+/**
+ * @brief apply a clock configuration computed by sysclock_plan()
+ * @param plan the plan to apply. must be valid
+ *
+ * @note
+ * follows the workflow of core_hook_sysclock_init():
+ * 1. configure SRAM wait cycles, and flash wait cycles safe for any HCLK
+ * 2. enable XTAL and configure the MPLL
+ * 3. configure the clock dividers
+ * 4. switch the system clock to MPLL, updating the power mode
+ * 5. lower the flash wait cycles to what the plan requires
+ */
+inline void sysclock_apply_plan(const sysclock_plan_t &plan)
+{
+  sysclock_configure_sram_wait_cycles(plan.sram_wait_cycles == 0 ? SramCycle1 : SramCycle2,
+                                      plan.sram_wait_cycles == 0 ? SramCycle1 : SramCycle2);
+  sysclock_configure_flash_wait_cycles();
+
+  sysclock_configure_xtal();
+  stc_clk_mpll_cfg_t pllConf = {
+      .PllpDiv = plan.mpll_p,
+      .PllqDiv = plan.mpll_q,
+      .PllrDiv = plan.mpll_r,
+      .plln = plan.mpll_n,
+      .pllmDiv = plan.mpll_m,
+  };
+  sysclock_configure_mpll(ClkPllSrcXTAL, &pllConf);
+
+  stc_clk_sysclk_cfg_t dividers = {
+      .enHclkDiv = static_cast<en_clk_sysclk_div_factor_t>(plan.hclk_div),
+      .enExclkDiv = static_cast<en_clk_sysclk_div_factor_t>(plan.exclk_div),
+      .enPclk0Div = static_cast<en_clk_sysclk_div_factor_t>(plan.pclk0_div),
+      .enPclk1Div = static_cast<en_clk_sysclk_div_factor_t>(plan.pclk1_div),
+      .enPclk2Div = static_cast<en_clk_sysclk_div_factor_t>(plan.pclk2_div),
+      .enPclk3Div = static_cast<en_clk_sysclk_div_factor_t>(plan.pclk3_div),
+      .enPclk4Div = static_cast<en_clk_sysclk_div_factor_t>(plan.pclk4_div),
+  };
+  sysclock_set_clock_dividers(&dividers);
+
+  power_mode_update_pre(plan.clocks.system);
+  CLK_SetSysClkSource(CLKSysSrcMPLL);
+  power_mode_update_post(plan.clocks.system);
+
+  sysclock_set_flash_wait_cycles(plan.flash_wait_cycles);
+}
+
+/**
+ * @brief implement core_hook_sysclock_init() using a clock configuration planned at compile time
+ * @param xtal the XTAL frequency, in Hz
+ * @param ... the targets, as designated initializers of sysclock_plan_targets_t
+ *
+ * @note
+ * e.g. 'SYSCLOCK_PLAN_INIT_HOOK(XTAL_VALUE, .hclk = 200000000, .pclk1 = 50000000)'.
+ * fails to compile if no legal configuration exists for the targets.
+ */
+#define SYSCLOCK_PLAN_INIT_HOOK(xtal, ...)                                                                \
+  extern "C" void core_hook_sysclock_init()                                                               \
+  {                                                                                                       \
+    constexpr sysclock_plan_t plan = sysclock_plan((xtal), sysclock_plan_targets_t{__VA_ARGS__});         \
+    static_assert(plan.valid, "no legal clock configuration for the XTAL frequency and targets");         \
+    sysclock_apply_plan(plan);                                                                            \
+  }
+
 #endif // __cplusplus
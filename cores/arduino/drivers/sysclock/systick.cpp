@@ -1,4 +1,9 @@
 #include "systick.h"
+#include "timebase_util.h"
+#include "../softtimer/soft_timer.h"
+#include "../interrupts/irq_priority.h"
+#include "../../core_critical.h"
+#include "../../core_sections.h"
 #include <hc32_ddl.h>
 
 /**
@@ -6,16 +11,61 @@
  */
 volatile uint32_t ticks_ms = 0;
 
-extern "C" void SysTick_Handler(void)
+/**
+ * @brief upper 32 bits of the uptime counter
+ */
+static volatile uint32_t ticks_ms_high = 0;
+
+/**
+ * @brief microseconds per systick clock tick, as reciprocal of (1000 / ticks per ms)
+ */
+static uint32_t us_per_tick = 0;
+
+/**
+ * @brief upper 32 bits of the DWT cycle counter, and the last value seen by the systick interrupt
+ */
+static volatile uint32_t cycles_high = 0;
+static volatile uint32_t cycles_last = 0;
+
+extern "C" CORE_RAMFUNC void SysTick_Handler(void)
 {
-  __sync_fetch_and_add(&ticks_ms, 1);
+  const uint32_t now = __sync_add_and_fetch(&ticks_ms, 1);
+  if (now == 0)
+  {
+    ticks_ms_high = ticks_ms_high + 1;
+  }
+
+  // extend the DWT cycle counter. it wraps every ~21 seconds at 200 MHz, so no wrap is missed
+  const uint32_t cycles = DWT->CYCCNT;
+  if (cycles < cycles_last)
+  {
+    cycles_high = cycles_high + 1;
+  }
+  cycles_last = cycles;
+
+  // expire software timers
+  soft_timer_tick(now);
 }
 
 void systick_init()
 {
+  // systick is clocked by HCLK
   stc_clk_freq_t clkFreq;
   CLK_GetClockFreq(&clkFreq);
-  SysTick_Config(clkFreq.sysclkFreq / 1000); // tick every 1 ms
+  SysTick_Config(clkFreq.hclkFreq / 1000); // tick every 1 ms
+  NVIC_SetPriority(SysTick_IRQn, IRQ_PRIORITY_SYSTICK);
+
+  // precompute the reciprocal, so micros() does not need to divide
+  us_per_tick = timebase_reciprocal(1000, SysTick->LOAD + 1);
+}
+
+void systick_update_clock(uint32_t hclk)
+{
+  // restart the current millisecond with the new reload value.
+  // the part of the millisecond that already passed is lost
+  SysTick->LOAD = (hclk / 1000) - 1;
+  SysTick->VAL = 0;
+  us_per_tick = timebase_reciprocal(1000, SysTick->LOAD + 1);
 }
 
 uint32_t systick_millis()
@@ -23,30 +73,57 @@ uint32_t systick_millis()
   return ticks_ms;
 }
 
-uint32_t systick_micros()
+/**
+ * @brief read the millisecond counter and the systick counter consistently
+ * @param ms_high upper 32 bits of the millisecond counter
+ * @param ms lower 32 bits of the millisecond counter
+ * @return microseconds elapsed in the current millisecond
+ */
+static inline uint32_t systick_read(uint32_t &ms_high, uint32_t &ms)
 {
   // based on implementation by STM32duino
   // https://github.com/stm32duino/Arduino_Core_STM32/blob/586319c6c2cee268747c8826d93e84b26d1549fd/libraries/SrcWrapper/src/stm32/clock.c#L29
+  // if the millisecond counter changed while reading the systick counter, a systick occurred and we read again
+  uint32_t ticks;
+  do
+  {
+    ms_high = ticks_ms_high;
+    ms = ticks_ms;
+    ticks = SysTick->VAL;
+  } while (ms != ticks_ms || ms_high != ticks_ms_high);
+
+  // systick counts down from LOAD to 0
+  return timebase_scale(SysTick->LOAD - ticks, us_per_tick);
+}
 
-  // read systick counter value and millis counter value
-  uint32_t ms = ticks_ms;
-  volatile uint32_t ticks = SysTick->VAL;
+uint32_t systick_micros()
+{
+  uint32_t ms_high, ms;
+  const uint32_t us = systick_read(ms_high, ms);
+  return (ms * 1000) + us;
+}
+
+uint64_t systick_micros64()
+{
+  uint32_t ms_high, ms;
+  const uint32_t us = systick_read(ms_high, ms);
+  return (((static_cast<uint64_t>(ms_high) << 32) | ms) * 1000) + us;
+}
 
-  // and again
-  uint32_t ms2 = ticks_ms;
-  volatile uint32_t ticks2 = SysTick->VAL;
+uint64_t systick_uptime_cycles()
+{
+  uint32_t high, last, cycles;
+  CORE_CRITICAL_SECTION(0, {
+    high = cycles_high;
+    last = cycles_last;
+    cycles = DWT->CYCCNT;
+  });
 
-  // if ms != ms2, then a systick occurred between the two reads
-  // and we must use ms2 and ticks2
-  if (ms != ms2)
+  // wrapped since the last systick
+  if (cycles < last)
   {
-    ms = ms2;
-    ticks = ticks2;
+    high++;
   }
 
-  // get ticks per ms
-  const uint32_t ticks_per_ms = SysTick->LOAD + 1;
-
-  // calculate microseconds
-  return (ms * 1000) + (((ticks_per_ms - ticks) * 1000) / ticks_per_ms);
+  return (static_cast<uint64_t>(high) << 32) | cycles;
 }
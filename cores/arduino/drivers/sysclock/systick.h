@@ -2,5 +2,24 @@
 #include <stdint.h>
 
 void systick_init();
+
+/**
+ * @brief update the systick reload value after HCLK changed
+ * @param hclk the new HCLK frequency, in Hz
+ * @note must be called with interrupts masked
+ */
+void systick_update_clock(uint32_t hclk);
 uint32_t systick_millis();
 uint32_t systick_micros();
+
+/**
+ * @brief get the number of microseconds since systick_init(), without rollover
+ */
+uint64_t systick_micros64();
+
+/**
+ * @brief get the number of CPU cycles since the DWT cycle counter was enabled, without rollover
+ * @note the 32 bit DWT counter is extended to 64 bit in the systick interrupt
+ * @note the DWT counter does not count while the CPU is sleeping (WFI / WFE)
+ */
+uint64_t systick_uptime_cycles();
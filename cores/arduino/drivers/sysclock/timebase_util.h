@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * fixed-point helpers for the timebase.
+ *
+ * conversions between clock ticks and time units are done by multiplying with a precomputed 0.32 fixed-point
+ * reciprocal, instead of dividing on every call. the reciprocals are computed once, whenever the clock changes.
+ */
+
+/**
+ * @brief compute the 0.32 fixed-point reciprocal of num / den, rounded up
+ * @param num numerator
+ * @param den denominator. must be > num
+ * @return ceil((num * 2^32) / den)
+ */
+constexpr uint32_t timebase_reciprocal(const uint32_t num, const uint32_t den)
+{
+    return static_cast<uint32_t>(((static_cast<uint64_t>(num) << 32) + den - 1) / den);
+}
+
+/**
+ * @brief scale a value by a reciprocal, rounding down
+ * @param x value to scale
+ * @param reciprocal reciprocal from timebase_reciprocal()
+ * @return x * (num / den)
+ * @note since the reciprocal is rounded up, the result may be one more than the exact value
+ *       if the exact value is just below a integer. the result is monotonic in x.
+ */
+constexpr uint32_t timebase_scale(const uint32_t x, const uint32_t reciprocal)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(x) * reciprocal) >> 32);
+}
+
+/**
+ * @brief scale a value by a reciprocal, rounding up
+ * @param x value to scale
+ * @param reciprocal reciprocal from timebase_reciprocal()
+ * @return x * (num / den), never less than the exact value
+ * @note use for delays, which must never be shorter than requested
+ */
+constexpr uint32_t timebase_scale_ceil(const uint32_t x, const uint32_t reciprocal)
+{
+    return static_cast<uint32_t>(((static_cast<uint64_t>(x) * reciprocal) + 0xFFFFFFFFull) >> 32);
+}
@@ -0,0 +1,335 @@
+#include "timera_capture.h"
+#include "timera_pwm.h"
+#include "timera_tone.h"
+#include "../gpio/gpio.h"
+#include "../interrupts/interrupts.h"
+
+/**
+ * @brief minimum counting frequency when the capture initializes the unit itself
+ * @note the highest divider that still reaches this frequency is used, to maximize the time between overflows
+ */
+#define TIMERA_CAPTURE_MIN_TICK_FREQUENCY 1000000
+
+//
+// internal helpers
+//
+
+/**
+ * @brief get the flag of a capture channel
+ */
+inline en_timera_flag_type_t timera_capture_channel_flag(const en_timera_channel_t channel)
+{
+    return static_cast<en_timera_flag_type_t>(TimeraFlagCaptureOrCompareCh1 + static_cast<uint8_t>(channel));
+}
+
+/**
+ * @brief get the interrupt of a capture channel
+ */
+inline en_timera_irq_type_t timera_capture_channel_irq(const en_timera_channel_t channel)
+{
+    return static_cast<en_timera_irq_type_t>(TimeraIrqCaptureOrCompareCh1 + static_cast<uint8_t>(channel));
+}
+
+/**
+ * @brief arm a capture channel for a rising or falling edge on the channel pin
+ */
+inline void timera_capture_arm(M4_TMRA_TypeDef *timera, const en_timera_channel_t channel, const bool rising)
+{
+    stc_timera_capture_init_t capture_config = {};
+    capture_config.enCapturePwmRisingEn = rising ? Enable : Disable;
+    capture_config.enCapturePwmFallingEn = rising ? Disable : Enable;
+    capture_config.enCaptureSpecifyEventEn = Disable;
+    capture_config.enPwmClkDiv = TimeraFilterPclkDiv1;
+    capture_config.enPwmFilterEn = Disable;
+    capture_config.enCaptureTrigRisingEn = Disable;
+    capture_config.enCaptureTrigFallingEn = Disable;
+    capture_config.enTrigClkDiv = TimeraFilterPclkDiv1;
+    capture_config.enTrigFilterEn = Disable;
+    TIMERA_CaptureInit(timera, channel, &capture_config);
+}
+
+/**
+ * @brief handle a captured edge
+ * @param unit the unit the edge was captured on
+ * @param channel the channel the edge was captured on
+ * @param timestamp extended timestamp of the edge
+ */
+static void timera_capture_handle_edge(timera_config_t *unit, const en_timera_channel_t channel, const uint32_t timestamp)
+{
+    M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+    timera_capture_channel_state_t *ch = &unit->state.capture->channel[channel];
+
+    const bool rising = ch->armed_rising;
+    const uint32_t edge = ch->edge_count + 1;
+    ch->edge_count = edge;
+
+    // a valid previous edge of the opposite direction completes a pulse
+    if (ch->last_edge_valid)
+    {
+        if (rising)
+        {
+            ch->low_ticks = timestamp - ch->last_edge;
+            ch->low_start_edge = edge - 1;
+        }
+        else
+        {
+            ch->high_ticks = timestamp - ch->last_edge;
+            ch->high_start_edge = edge - 1;
+        }
+    }
+
+    if (rising)
+    {
+        if (ch->last_rise_edge != 0)
+        {
+            ch->period_ticks = timestamp - ch->last_rise;
+        }
+
+        ch->last_rise = timestamp;
+        ch->last_rise_edge = edge;
+    }
+
+    ch->last_edge = timestamp;
+    ch->last_edge_valid = true;
+
+    // arm the opposite edge
+    ch->armed_rising = !rising;
+    timera_capture_arm(timera, channel, !rising);
+
+    // if the pin already went back to the previous level but nothing was captured, the opposite edge was missed.
+    // discard the partial measurement and wait for the next edge of the same direction
+    const bool level = GPIO_GetBit(ch->pin) == Set;
+    if (level != rising && TIMERA_GetFlag(timera, timera_capture_channel_flag(channel)) != Set)
+    {
+        ch->last_edge_valid = false;
+        if (!rising)
+        {
+            // missed a rising edge, so the next rising edge doesn't complete a period
+            ch->last_rise_edge = 0;
+        }
+
+        ch->armed_rising = rising;
+        timera_capture_arm(timera, channel, rising);
+    }
+}
+
+/**
+ * @brief input capture interrupt handler, shared by the compare and overflow interrupts of a unit
+ * @param unit the unit that raised the interrupt
+ */
+static void timera_capture_irq_handler(timera_config_t *unit)
+{
+    M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+    timera_capture_state_t *state = unit->state.capture;
+
+    for (uint8_t c = 0; c < 8; c++)
+    {
+        const en_timera_channel_t channel = static_cast<en_timera_channel_t>(c);
+        if ((state->channels & TIMERA_STATE_ACTIVE_CHANNEL_BIT(c + 1)) == 0 ||
+            TIMERA_GetFlag(timera, timera_capture_channel_flag(channel)) != Set)
+        {
+            continue;
+        }
+
+        TIMERA_ClearFlag(timera, timera_capture_channel_flag(channel));
+        const uint16_t value = TIMERA_GetCaptureValue(timera, channel);
+
+        // if a overflow is pending and the captured value is in the lower half of the period,
+        // the capture happened after the overflow that was not counted yet
+        uint32_t overflow_ticks = state->overflow_ticks;
+        if (TIMERA_GetFlag(timera, TimeraFlagOverflow) == Set && value < (state->period / 2))
+        {
+            overflow_ticks += state->period;
+        }
+
+        timera_capture_handle_edge(unit, channel, overflow_ticks + value);
+    }
+
+    if (TIMERA_GetFlag(timera, TimeraFlagOverflow) == Set)
+    {
+        TIMERA_ClearFlag(timera, TimeraFlagOverflow);
+        state->overflow_ticks = state->overflow_ticks + state->period;
+    }
+}
+
+//
+// IRQ registration
+//
+
+inline bool timera_capture_irq_register(timera_interrupt_config_t &irq, const func_ptr_t handler)
+{
+    const int irqn = interrupt_register(irq.interrupt_source, handler);
+    CORE_ASSERT(irqn >= 0, "timera capture interrupt registration failed", return false);
+    irq.interrupt_number = static_cast<IRQn_Type>(irqn);
+
+    NVIC_SetPriority(irq.interrupt_number, IRQ_PRIORITY_TIMERA);
+    NVIC_ClearPendingIRQ(irq.interrupt_number);
+    NVIC_EnableIRQ(irq.interrupt_number);
+    return true;
+}
+
+inline void timera_capture_irq_resign(timera_interrupt_config_t &irq)
+{
+    NVIC_DisableIRQ(irq.interrupt_number);
+    NVIC_ClearPendingIRQ(irq.interrupt_number);
+    interrupt_resign(irq.interrupt_number);
+}
+
+//
+// public API
+//
+
+/**
+ * @brief initialize the unit for input capture, or check the existing configuration is usable
+ */
+inline en_result_t timera_capture_unit_init(timera_config_t *unit)
+{
+    // a tone owns the unit
+    if (timera_tone_is_active(unit))
+    {
+        return ErrorOperationInProgress;
+    }
+
+    if (timera_is_unit_initialized(unit))
+    {
+        // capture requires the counter to count up to PERAR and restart from 0
+        const stc_timera_base_init_t *current_config = unit->state.base_init;
+        if (current_config->enCntMode != TimeraCountModeSawtoothWave || current_config->enCntDir != TimeraCountDirUp)
+        {
+            return ErrorOperationInProgress;
+        }
+
+        TIMERA_DEBUG_PRINTF(unit, -2, "capture_start: using existing config\n");
+        return Ok;
+    }
+
+    // use the highest divider that still counts at TIMERA_CAPTURE_MIN_TICK_FREQUENCY or faster
+    const uint32_t base_clock = timera_get_base_clock();
+    uint16_t divider = 1;
+    while (divider < 1024 && (base_clock / (divider * 2)) >= TIMERA_CAPTURE_MIN_TICK_FREQUENCY)
+    {
+        divider *= 2;
+    }
+
+    // (when initializing, a pointer to this is stored in the unit's state. so we need to allocate it on the heap)
+    stc_timera_base_init_t *unit_config = new stc_timera_base_init_t;
+    CORE_ASSERT(unit_config != nullptr, "", return Error);
+
+    unit_config->enClkDiv = timera_n_to_clk_div(divider); // PCLK1 / divider
+    unit_config->enCntMode = TimeraCountModeSawtoothWave; // sawtooth wave mode
+    unit_config->enCntDir = TimeraCountDirUp;             // count up
+    unit_config->enSyncStartupEn = Disable;               // no sync startup
+    unit_config->u16PeriodVal = 0xFFFF;                   // full 16 bit range
+
+    TIMERA_DEBUG_PRINTF(unit, -2, "capture_start: init with PCLK1/%d\n", divider);
+
+    PWC_Fcg2PeriphClockCmd(unit->peripheral.clock_id, Enable);
+    PWC_Fcg0PeriphClockCmd(PWC_FCG0_PERIPH_AOS, Enable);
+    TIMERA_BaseInit(unit->peripheral.register_base, unit_config);
+    unit->state.base_init = unit_config;
+    return Ok;
+}
+
+en_result_t timera_capture_start(timera_config_t *unit,
+                                 const en_timera_channel_t channel,
+                                 const gpio_pin_t pin,
+                                 const en_port_func_t function)
+{
+    CORE_ASSERT(unit != nullptr, "timera_capture_start: unit is nullptr", return ErrorInvalidParameter);
+    ASSERT_GPIO_PIN_VALID(pin, "timera_capture_start", return ErrorInvalidParameter);
+
+    if (timera_capture_is_active(unit, channel))
+    {
+        return Ok;
+    }
+
+    // channel is used for PWM output
+    if (timera_is_channel_active(unit, channel))
+    {
+        return ErrorOperationInProgress;
+    }
+
+    const en_result_t rc = timera_capture_unit_init(unit);
+    if (rc != Ok)
+    {
+        return rc;
+    }
+
+    // allocate capture state on first use
+    if (unit->state.capture == NULL)
+    {
+        unit->state.capture = new timera_capture_state_t();
+        CORE_ASSERT(unit->state.capture != nullptr, "", return Error);
+    }
+
+    M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+    timera_capture_state_t *state = unit->state.capture;
+    const bool is_first_channel = state->channels == 0;
+    if (is_first_channel)
+    {
+        state->overflow_ticks = 0;
+        state->period = static_cast<uint32_t>(TIMERA_GetPeriodValue(timera)) + 1;
+        state->tick_frequency = timera_get_base_clock() / timera_clk_div_to_n(unit->state.base_init->enClkDiv);
+    }
+
+    // reset channel state, the first edge is the one opposite to the current level
+    timera_capture_channel_state_t *ch = &state->channel[channel];
+    *ch = {};
+    ch->pin = pin;
+    ch->armed_rising = GPIO_GetBit(pin) != Set;
+
+    TIMERA_DEBUG_PRINTF(unit, channel, "capture_start: pin %d, period=%ld, f=%ld\n", pin, state->period, state->tick_frequency);
+
+    // connect pin to the channel and arm it
+    GPIO_SetFunc(pin, function, Disable);
+    timera_capture_arm(timera, channel, ch->armed_rising);
+    TIMERA_ClearFlag(timera, timera_capture_channel_flag(channel));
+    TIMERA_IrqCmd(timera, timera_capture_channel_irq(channel), Enable);
+
+    state->channels |= TIMERA_STATE_ACTIVE_CHANNEL_BIT(static_cast<uint8_t>(channel) + 1);
+    timera_set_channel_active_flag(unit, channel, true);
+
+    // the first channel enables the unit interrupts
+    if (is_first_channel)
+    {
+        const func_ptr_t handler = timera_get_irq_entry_point<timera_capture_irq_handler>(unit);
+        CORE_ASSERT(handler != nullptr, "timera_capture_start: unknown unit", return Error);
+
+        timera_capture_irq_register(unit->compare_interrupt, handler);
+        timera_capture_irq_register(unit->overflow_interrupt, handler);
+
+        TIMERA_ClearFlag(timera, TimeraFlagOverflow);
+        TIMERA_IrqCmd(timera, TimeraIrqOverflow, Enable);
+    }
+
+    return TIMERA_Cmd(timera, Enable);
+}
+
+void timera_capture_stop(timera_config_t *unit, const en_timera_channel_t channel)
+{
+    CORE_ASSERT(unit != nullptr, "timera_capture_stop: unit is nullptr", return);
+    if (!timera_capture_is_active(unit, channel))
+    {
+        return;
+    }
+
+    M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+    timera_capture_state_t *state = unit->state.capture;
+    TIMERA_DEBUG_PRINTF(unit, channel, "capture_stop\n");
+
+    // disconnect channel
+    TIMERA_IrqCmd(timera, timera_capture_channel_irq(channel), Disable);
+    GPIO_SetFunc(state->channel[channel].pin, Func_Gpio, Disable);
+
+    state->channels &= ~TIMERA_STATE_ACTIVE_CHANNEL_BIT(static_cast<uint8_t>(channel) + 1);
+    timera_set_channel_active_flag(unit, channel, false);
+
+    // the last channel disables the unit interrupts, and the unit if no PWM channels remain
+    if (state->channels == 0)
+    {
+        TIMERA_IrqCmd(timera, TimeraIrqOverflow, Disable);
+        timera_capture_irq_resign(unit->compare_interrupt);
+        timera_capture_irq_resign(unit->overflow_interrupt);
+        timera_pwm_stop_if_not_in_use(unit);
+    }
+}
@@ -0,0 +1,202 @@
+/**
+ * TimerA input capture:
+ *
+ * for input capture, the TimerA unit is configured in Sawtooth counting mode, counting up to PERAR.
+ * if the unit is already running (e.g. for PWM on another channel), the existing configuration is reused.
+ *
+ * each edge on a capture channel's pin latches the counter value into the channel's compare register and raises
+ * the compare interrupt. the interrupt handler extends the 16 bit counter value to a 32 bit timestamp using the
+ * ticks counted by the counter overflows:
+ *
+ *  timestamp = overflow_ticks + captured_value, with overflow_ticks += (PERAR + 1) on every overflow
+ *
+ * timestamps wrap around modulo 2^32, so the difference between two timestamps stays correct across the wrap,
+ * for any PERAR.
+ *
+ * the channel alternates between capturing rising and falling edges, so every captured edge is known to be either
+ * rising or falling. from these, the handler calculates the high time, low time and period of the signal.
+ * if the opposite edge occurs before the handler re-arms the channel, the edge is missed and the measurement discarded.
+ */
+#pragma once
+#include "timera_util.h"
+
+/**
+ * @brief state of a input capture channel
+ * @note timestamps and widths are in timer ticks
+ */
+typedef struct timera_capture_channel_state_t
+{
+    /**
+     * @brief gpio pin of the channel
+     */
+    gpio_pin_t pin;
+
+    /**
+     * @brief is the channel currently armed for a rising edge?
+     */
+    volatile bool armed_rising;
+
+    /**
+     * @brief is last_edge valid?
+     */
+    volatile bool last_edge_valid;
+
+    /**
+     * @brief number of edges captured
+     */
+    volatile uint32_t edge_count;
+
+    /**
+     * @brief timestamp of the last captured edge
+     */
+    volatile uint32_t last_edge;
+
+    /**
+     * @brief timestamp of the last valid rising edge
+     * @note valid if last_rise_edge != 0
+     */
+    volatile uint32_t last_rise;
+
+    /**
+     * @brief edge index (edge_count) of last_rise
+     */
+    volatile uint32_t last_rise_edge;
+
+    /**
+     * @brief width of the last complete high pulse
+     */
+    volatile uint32_t high_ticks;
+
+    /**
+     * @brief edge index (edge_count) of the rising edge that started the last complete high pulse
+     * @note 0 if no high pulse was measured yet
+     */
+    volatile uint32_t high_start_edge;
+
+    /**
+     * @brief width of the last complete low pulse
+     */
+    volatile uint32_t low_ticks;
+
+    /**
+     * @brief edge index (edge_count) of the falling edge that started the last complete low pulse
+     * @note 0 if no low pulse was measured yet
+     */
+    volatile uint32_t low_start_edge;
+
+    /**
+     * @brief time between the last two rising edges
+     * @note 0 if no period was measured yet
+     */
+    volatile uint32_t period_ticks;
+} timera_capture_channel_state_t;
+
+/**
+ * @brief input capture state of a TimerA unit
+ */
+typedef struct timera_capture_state_t
+{
+    /**
+     * @brief ticks counted by the counter overflows since capture was started, modulo 2^32
+     */
+    volatile uint32_t overflow_ticks;
+
+    /**
+     * @brief counter period, in ticks (PERAR + 1)
+     */
+    uint32_t period;
+
+    /**
+     * @brief counting frequency of the unit, in Hz
+     */
+    uint32_t tick_frequency;
+
+    /**
+     * @brief channels with input capture enabled
+     * @note use TIMERA_STATE_ACTIVE_CHANNEL_BIT(ch) to get bit positions
+     */
+    uint8_t channels;
+
+    /**
+     * @brief per-channel state
+     */
+    timera_capture_channel_state_t channel[8];
+} timera_capture_state_t;
+
+/**
+ * @brief start input capture on a channel
+ * @param unit pointer to timera unit config
+ * @param channel channel to capture on
+ * @param pin gpio pin assigned to the channel
+ * @param function gpio function to connect the pin to the channel
+ * @return Ok on success,
+ *         ErrorInvalidParameter if parameters not valid,
+ *         ErrorOperationInProgress if the unit is in use with a incompatible config or the channel is in use
+ * @note if capture is already running on the channel, this function does nothing
+ */
+en_result_t timera_capture_start(timera_config_t *unit,
+                                 const en_timera_channel_t channel,
+                                 const gpio_pin_t pin,
+                                 const en_port_func_t function);
+
+/**
+ * @brief stop input capture on a channel
+ * @param unit pointer to timera unit config
+ * @param channel channel to stop
+ * @note the unit is stopped if no other channel is in use
+ * @note the pin is reset to GPIO function
+ */
+void timera_capture_stop(timera_config_t *unit, const en_timera_channel_t channel);
+
+/**
+ * @brief check if input capture is running on a channel
+ * @param unit pointer to timera unit config
+ * @param channel channel to check
+ */
+inline bool timera_capture_is_active(const timera_config_t *unit, const en_timera_channel_t channel)
+{
+    return unit->state.capture != NULL &&
+           (unit->state.capture->channels & TIMERA_STATE_ACTIVE_CHANNEL_BIT(static_cast<uint8_t>(channel) + 1)) != 0;
+}
+
+/**
+ * @brief get the state of a capture channel
+ * @param unit pointer to timera unit config
+ * @param channel channel to get state of
+ * @return channel state, or NULL if capture is not running on the channel
+ */
+inline const timera_capture_channel_state_t *timera_capture_get_channel(const timera_config_t *unit, const en_timera_channel_t channel)
+{
+    return timera_capture_is_active(unit, channel) ? &unit->state.capture->channel[channel] : NULL;
+}
+
+/**
+ * @brief read the last complete pulse of a capture channel
+ * @param channel capture channel state
+ * @param high true to read the last high pulse, false to read the last low pulse
+ * @param ticks width of the pulse, in ticks
+ * @return edge index of the edge that started the pulse. 0 if no pulse was measured yet
+ * @note safe to call while the interrupt handler updates the state
+ */
+inline uint32_t timera_capture_read_pulse(const timera_capture_channel_state_t *channel, const bool high, uint32_t &ticks)
+{
+    uint32_t start_edge;
+    do
+    {
+        start_edge = high ? channel->high_start_edge : channel->low_start_edge;
+        ticks = high ? channel->high_ticks : channel->low_ticks;
+    } while (start_edge != (high ? channel->high_start_edge : channel->low_start_edge));
+
+    return start_edge;
+}
+
+/**
+ * @brief convert capture ticks to microseconds
+ * @param unit pointer to timera unit config. capture must have been started on the unit
+ * @param ticks ticks to convert
+ * @return ticks in microseconds
+ */
+inline uint32_t timera_capture_ticks_to_us(const timera_config_t *unit, const uint32_t ticks)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(ticks) * 1000000ull) / unit->state.capture->tick_frequency);
+}
@@ -0,0 +1,61 @@
+#include "timera_pwm.h"
+#include "timera_capture.h"
+
+/**
+ * @brief scale a counter value by new_clock / old_clock
+ * @return the scaled value, constrained to [0, 0xFFFF]
+ */
+static uint16_t scale_count(const uint16_t value, const uint32_t old_clock, const uint32_t new_clock)
+{
+    const uint64_t scaled = (static_cast<uint64_t>(value) * new_clock + (old_clock / 2)) / old_clock;
+    return static_cast<uint16_t>(TIMERA_CONSTRAIN(scaled, 0ull, 0xFFFFull));
+}
+
+void timera_update_clock(const system_clock_frequencies_t *old_clocks)
+{
+    const uint32_t old_pclk1 = old_clocks->pclk1;
+    const uint32_t new_pclk1 = SYSTEM_CLOCK_FREQUENCIES.pclk1;
+    if (old_pclk1 == new_pclk1 || old_pclk1 == 0)
+    {
+        return;
+    }
+
+    for (timera_config_t *unit : TIMERA_UNITS)
+    {
+        if (!timera_is_unit_initialized(unit))
+        {
+            continue;
+        }
+
+        M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+        timera_capture_state_t *capture = unit->state.capture;
+        if (capture != nullptr && capture->channels != 0)
+        {
+            // input capture timestamps are based on PERAR, so keep it and only update the tick frequency.
+            // PWM channels sharing the unit change their frequency
+            capture->tick_frequency = new_pclk1 / timera_clk_div_to_n(unit->state.base_init->enClkDiv);
+            TIMERA_DEBUG_PRINTF(unit, -2, "update_clock: capture tick_frequency=%lu\n", capture->tick_frequency);
+            continue;
+        }
+
+        // scale PERAR and all compare values, so PWM and tone keep their frequency and duty cycle
+        const uint16_t old_period = TIMERA_GetPeriodValue(timera);
+        const uint16_t period = TIMERA_CONSTRAIN(scale_count(old_period, old_pclk1, new_pclk1), 1, 0xFFFF);
+        for (uint8_t ch = TimeraCh1; ch <= TimeraCh8; ch++)
+        {
+            const en_timera_channel_t channel = static_cast<en_timera_channel_t>(ch);
+            const uint16_t compare = TIMERA_GetCompareValue(timera, channel);
+            TIMERA_SetCompareValue(timera, channel, compare >= old_period ? period : scale_count(compare, old_pclk1, new_pclk1));
+        }
+        TIMERA_SetPeriodValue(timera, period);
+        unit->state.base_init->u16PeriodVal = period;
+
+        // if the counter is already past the new PERAR, restart the period instead of counting up to 0xFFFF
+        if (TIMERA_GetCurrCount(timera) >= period)
+        {
+            TIMERA_SetCurrCount(timera, 0);
+        }
+
+        TIMERA_DEBUG_PRINTF(unit, -2, "update_clock: PERAR %d -> %d\n", old_period, period);
+    }
+}
@@ -95,3 +95,12 @@ timera_config_t TIMERA6_config = {
         .interrupt_source = INT_TMRA6_CMP,
     },
 };
+
+timera_config_t *const TIMERA_UNITS[TIMERA_UNIT_COUNT] = {
+    &TIMERA1_config,
+    &TIMERA2_config,
+    &TIMERA3_config,
+    &TIMERA4_config,
+    &TIMERA5_config,
+    &TIMERA6_config,
+};
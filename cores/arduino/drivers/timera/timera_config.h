@@ -58,6 +58,18 @@ typedef struct timera_runtime_state_t
      * @note use TIMERA_STATE_ACTIVE_CHANNEL_BIT(ch) to get bit positions
      */
     uint8_t active_channels;
+
+    /**
+     * @brief TimerA unit input capture state
+     * @note NULL if input capture was never used on this unit
+     */
+    struct timera_capture_state_t *capture;
+
+    /**
+     * @brief TimerA unit tone state
+     * @note NULL if tone was never used on this unit
+     */
+    struct timera_tone_state_t *tone;
 } timera_runtime_state_t;
 
 /**
@@ -128,3 +140,13 @@ extern timera_config_t TIMERA5_config;
  * @brief TimerA Unit 6 configuration
  */
 extern timera_config_t TIMERA6_config;
+
+/**
+ * @brief number of TimerA units
+ */
+#define TIMERA_UNIT_COUNT 6
+
+/**
+ * @brief all TimerA unit configurations, indexed by unit number - 1
+ */
+extern timera_config_t *const TIMERA_UNITS[TIMERA_UNIT_COUNT];
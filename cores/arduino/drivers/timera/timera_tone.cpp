@@ -0,0 +1,184 @@
+#include "timera_tone.h"
+#include "timera_pwm.h"
+#include "../gpio/gpio.h"
+
+//
+// internal helpers
+//
+
+/**
+ * @brief silence the tone output, without releasing the unit
+ * @note safe to call from interrupt context
+ */
+static void timera_tone_silence(timera_config_t *unit)
+{
+    M4_TMRA_TypeDef *timera = unit->peripheral.register_base;
+    timera_tone_state_t *state = unit->state.tone;
+
+    TIMERA_Cmd(timera, Disable);
+
+    // drive the pin low while silent
+    GPIO_ResetBits(state->pin);
+    GPIO_SetFunc(state->pin, Func_Gpio, Disable);
+    GPIO_OE(state->pin, Enable);
+
+    state->playing = false;
+}
+
+/**
+ * @brief duration timer callback, silences a tone whose duration expired
+ * @param arg the unit playing the tone
+ * @note runs in the systick interrupt. releasing the unit frees heap memory, so that is left to
+ *       timera_tone_stop() or the next timera_tone_start()
+ */
+static void timera_tone_expired(void *arg)
+{
+    timera_config_t *unit = static_cast<timera_config_t *>(arg);
+    if (unit->state.tone->playing)
+    {
+        timera_tone_silence(unit);
+    }
+}
+
+/**
+ * @brief release the unit used by a tone
+ */
+static void timera_tone_release(timera_config_t *unit)
+{
+    timera_tone_state_t *state = unit->state.tone;
+
+    // stop the duration timer first, so it cannot silence the tone concurrently
+    soft_timer_stop(&state->duration_timer);
+    if (state->playing)
+    {
+        timera_tone_silence(unit);
+    }
+
+    state->active = false;
+    timera_pwm_stop_hard(unit);
+}
+
+/**
+ * @brief initialize the unit with the period of the tone frequency
+ * @param unit the unit to initialize. must not be initialized
+ * @param frequency tone frequency, in Hz
+ * @note unlike timera_pwm_start(), PERAR is calculated from the frequency directly, not from a period in whole
+ *       microseconds, which would put audible tones noticeably off pitch
+ */
+static en_result_t timera_tone_init_unit(timera_config_t *unit, const uint32_t frequency)
+{
+    // the counter counts from 0 to PERAR, so a period is PERAR + 1 ticks.
+    // use the smallest divider that fits the period into PERAR, for the best frequency resolution
+    const uint32_t base_clock = timera_get_base_clock();
+    uint32_t divider = 1;
+    while (divider < 1024 && (base_clock / divider / frequency) > 0x10000)
+    {
+        divider *= 2;
+    }
+
+    const uint32_t f_base = base_clock / divider;
+    const uint32_t period_ticks = (f_base + (frequency / 2)) / frequency;
+    CORE_ASSERT(period_ticks >= 2 && period_ticks <= 0x10000, "timera_tone_start: frequency out of range",
+                return ErrorInvalidParameter);
+
+    // (when initializing, a pointer to this is stored in the unit's state. so we need to allocate it on the heap)
+    stc_timera_base_init_t *base_init = new stc_timera_base_init_t;
+    CORE_ASSERT(base_init != nullptr, "", return Error);
+
+    base_init->enClkDiv = timera_n_to_clk_div(divider);
+    base_init->enCntMode = TimeraCountModeSawtoothWave;
+    base_init->enCntDir = TimeraCountDirUp;
+    base_init->enSyncStartupEn = Disable;
+    base_init->u16PeriodVal = static_cast<uint16_t>(period_ticks - 1);
+
+    TIMERA_DEBUG_PRINTF(unit, -2, "tone_init: f=%ldHz (PCLK1/%ld), PERAR=%d\n", frequency, divider, base_init->u16PeriodVal);
+
+    // start peripheral clocks for TimerA unit and AOS, and initialize the unit
+    PWC_Fcg2PeriphClockCmd(unit->peripheral.clock_id, Enable);
+    PWC_Fcg0PeriphClockCmd(PWC_FCG0_PERIPH_AOS, Enable);
+    TIMERA_BaseInit(unit->peripheral.register_base, base_init);
+    unit->state.base_init = base_init;
+
+    return TIMERA_Cmd(unit->peripheral.register_base, Enable);
+}
+
+//
+// public API
+//
+
+en_result_t timera_tone_start(timera_config_t *unit,
+                              const en_timera_channel_t channel,
+                              const gpio_pin_t pin,
+                              const en_port_func_t function,
+                              const uint32_t frequency,
+                              const uint32_t duration)
+{
+    CORE_ASSERT(unit != nullptr, "timera_tone_start: unit is nullptr", return ErrorInvalidParameter);
+    CORE_ASSERT(frequency > 0, "timera_tone_start: frequency must be > 0", return ErrorInvalidParameter);
+    ASSERT_GPIO_PIN_VALID(pin, "timera_tone_start", return ErrorInvalidParameter);
+
+    if (timera_tone_is_active(unit))
+    {
+        // only one tone per unit, since they would share the frequency.
+        // a tone whose duration expired is no longer playing, so any pin may take over the unit
+        if (unit->state.tone->playing && unit->state.tone->pin != pin)
+        {
+            return ErrorOperationInProgress;
+        }
+
+        // replace the current tone
+        timera_tone_release(unit);
+    }
+    else if (timera_is_unit_initialized(unit))
+    {
+        // unit is used for PWM or input capture, changing PERAR would affect the other channels
+        return ErrorOperationInProgress;
+    }
+
+    const en_result_t rc = timera_tone_init_unit(unit, frequency);
+    if (rc != Ok)
+    {
+        return rc;
+    }
+
+    // allocate tone state on first use
+    if (unit->state.tone == NULL)
+    {
+        unit->state.tone = new timera_tone_state_t();
+        CORE_ASSERT(unit->state.tone != nullptr, "", return Error);
+        soft_timer_init(&unit->state.tone->duration_timer, timera_tone_expired, unit, SOFT_TIMER_CONTEXT_ISR);
+    }
+
+    timera_tone_state_t *state = unit->state.tone;
+    state->pin = pin;
+    state->channel = channel;
+    state->active = true;
+    state->playing = true;
+
+    // 50% duty square wave
+    timera_pwm_channel_start(unit, channel, true);
+    timera_pwm_set_duty(unit, channel, 50, 100);
+    GPIO_SetFunc(pin, function, Disable);
+
+    TIMERA_DEBUG_PRINTF(unit, channel, "tone_start: pin %d, f=%ld, duration=%ld\n", pin, frequency, duration);
+
+    // a single software timer ends the tone, so the tone itself needs no interrupt
+    if (duration > 0)
+    {
+        soft_timer_start(&state->duration_timer, duration, 0);
+    }
+
+    return Ok;
+}
+
+void timera_tone_stop(timera_config_t *unit)
+{
+    CORE_ASSERT(unit != nullptr, "timera_tone_stop: unit is nullptr", return);
+    if (!timera_tone_is_active(unit))
+    {
+        return;
+    }
+
+    TIMERA_DEBUG_PRINTF(unit, unit->state.tone->channel, "tone_stop\n");
+    timera_tone_release(unit);
+}
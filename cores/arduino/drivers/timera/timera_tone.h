@@ -0,0 +1,83 @@
+/**
+ * TimerA tone generator:
+ *
+ * a tone is a PWM output at 50% duty, where the frequency is set through the period register (PERAR).
+ * since PERAR is shared by all channels of a unit, a tone requires exclusive use of the TimerA unit.
+ *
+ * if the tone has a duration, a software timer silences the output when the duration expired, so the tone
+ * does not interrupt the CPU while playing. the unit is released by timera_tone_stop() or the next timera_tone_start().
+ */
+#pragma once
+#include "timera_util.h"
+#include "../softtimer/soft_timer.h"
+
+/**
+ * @brief tone state of a TimerA unit
+ */
+typedef struct timera_tone_state_t
+{
+    /**
+     * @brief gpio pin the tone is played on
+     */
+    gpio_pin_t pin;
+
+    /**
+     * @brief channel the tone is played on
+     */
+    en_timera_channel_t channel;
+
+    /**
+     * @brief is the unit used for a tone?
+     * @note remains true after a tone with duration expired, until timera_tone_stop() or the next
+     *       timera_tone_start() is called. the next tone may use any pin of the unit
+     */
+    volatile bool active;
+
+    /**
+     * @brief is the tone output currently running?
+     */
+    volatile bool playing;
+
+    /**
+     * @brief silences the tone when its duration expired
+     * @note only active for tones with a duration
+     */
+    soft_timer_t duration_timer;
+} timera_tone_state_t;
+
+/**
+ * @brief start a tone on a channel
+ * @param unit pointer to timera unit config
+ * @param channel channel to play the tone on
+ * @param pin gpio pin assigned to the channel
+ * @param function gpio function to connect the pin to the channel
+ * @param frequency tone frequency, in Hz
+ * @param duration tone duration, in milliseconds. 0 to play until timera_tone_stop() is called
+ * @return Ok on success,
+ *         ErrorInvalidParameter if parameters not valid, e.g. the frequency is out of range,
+ *         ErrorOperationInProgress if the unit is in use, e.g. for PWM or by a tone on another pin
+ * @note a tone that is already playing on the same pin is replaced. a tone whose duration expired is replaced
+ *       on any pin
+ */
+en_result_t timera_tone_start(timera_config_t *unit,
+                              const en_timera_channel_t channel,
+                              const gpio_pin_t pin,
+                              const en_port_func_t function,
+                              const uint32_t frequency,
+                              const uint32_t duration);
+
+/**
+ * @brief stop the tone of a unit and release the unit
+ * @param unit pointer to timera unit config
+ * @note the pin is set to GPIO function and driven low
+ */
+void timera_tone_stop(timera_config_t *unit);
+
+/**
+ * @brief check if a unit is used for a tone
+ * @param unit pointer to timera unit config
+ */
+inline bool timera_tone_is_active(const timera_config_t *unit)
+{
+    return unit->state.tone != NULL && unit->state.tone->active;
+}
@@ -172,6 +172,65 @@ inline uint32_t timera_get_base_clock()
     return SYSTEM_CLOCK_FREQUENCIES.pclk1;
 }
 
+/**
+ * @brief get the index of a unit in TIMERA_UNITS
+ * @param unit pointer to timera unit config
+ * @return the index, or -1 if the unit is unknown
+ */
+inline int timera_get_unit_index(const timera_config_t *unit)
+{
+    for (int i = 0; i < TIMERA_UNIT_COUNT; i++)
+    {
+        if (TIMERA_UNITS[i] == unit)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief IRQ entry point of unit x, calling handler with the unit config
+ */
+template <void (*handler)(timera_config_t *unit), uint8_t x>
+static void timera_irq_entry_point(void)
+{
+    static_assert(x >= 1 && x <= TIMERA_UNIT_COUNT, "TimerA unit number must be between 1 and TIMERA_UNIT_COUNT");
+    handler(TIMERA_UNITS[x - 1]);
+}
+
+/**
+ * @brief get the IRQ entry point of a unit, for a handler shared by all units
+ * @tparam handler the handler, called with the config of the unit that raised the interrupt
+ * @param unit pointer to timera unit config
+ * @return the entry point, or nullptr if the unit is unknown
+ */
+template <void (*handler)(timera_config_t *unit)>
+inline func_ptr_t timera_get_irq_entry_point(const timera_config_t *unit)
+{
+    static const func_ptr_t entry_points[TIMERA_UNIT_COUNT] = {
+        timera_irq_entry_point<handler, 1>,
+        timera_irq_entry_point<handler, 2>,
+        timera_irq_entry_point<handler, 3>,
+        timera_irq_entry_point<handler, 4>,
+        timera_irq_entry_point<handler, 5>,
+        timera_irq_entry_point<handler, 6>,
+    };
+
+    const int index = timera_get_unit_index(unit);
+    return index < 0 ? nullptr : entry_points[index];
+}
+
+/**
+ * @brief update the TimerA units after PCLK1 changed
+ * @param old_clocks the clock frequencies before the change
+ * @note PWM and tone units keep their frequency and duty cycle, by scaling PERAR and the compare values.
+ *       input capture units keep PERAR, and only update their tick frequency
+ * @note called by sysclock_change(), with interrupts masked
+ */
+void timera_update_clock(const system_clock_frequencies_t *old_clocks);
+
 /**
  * @brief number to TimerA clock divider
  */
@@ -4,8 +4,12 @@
 #include "core_hooks.h"
 #include "core_debug.h"
 #include "yield.h"
+#include "core_idle.h"
+#include "core_sections.h"
 #include "../gpio/gpio.h"
 #include "../irqn/irqn.h"
+#include "../interrupts/interrupts.h"
+#include "../interrupts/irq_priority.h"
 #include "../sysclock/sysclock.h"
 
 //
@@ -22,6 +26,15 @@ Usart Serial3(&USART3_config, VARIANT_USART3_TX_PIN, VARIANT_USART3_RX_PIN);
 //
 inline void usart_irq_register(usart_interrupt_config_t &irq, const char *name)
 {
+    // low-rate interrupts go to a shared IRQ, leaving the dedicated ones to the rx and tx data interrupts
+    if (irq.interrupt_pending != nullptr)
+    {
+        const int irqn = interrupt_register_shared(irq.interrupt_source, irq.interrupt_handler, irq.interrupt_pending);
+        CORE_ASSERT(irqn >= 0, "failed to register shared USART IRQ", return);
+        irq.interrupt_number = static_cast<IRQn_Type>(irqn);
+        return;
+    }
+
     // get auto-assigned irqn and set in irq struct
     IRQn_Type irqn;
     irqn_aa_get(irqn, name);
@@ -36,13 +49,19 @@ inline void usart_irq_register(usart_interrupt_config_t &irq, const char *name)
 
     // register and enable irq
     enIrqRegistration(&irqConf);
-    NVIC_SetPriority(irqConf.enIRQn, DDL_IRQ_PRIORITY_03);
+    NVIC_SetPriority(irqConf.enIRQn, IRQ_PRIORITY_USART);
     NVIC_ClearPendingIRQ(irqConf.enIRQn);
     NVIC_EnableIRQ(irqConf.enIRQn);
 }
 
 inline void usart_irq_resign(usart_interrupt_config_t &irq, const char *name)
 {
+    if (irq.interrupt_pending != nullptr)
+    {
+        interrupt_resign_shared(irq.interrupt_source);
+        return;
+    }
+
     // disable interrupt and clear pending
     NVIC_DisableIRQ(irq.interrupt_number);
     NVIC_ClearPendingIRQ(irq.interrupt_number);
@@ -315,7 +334,7 @@ void Usart::rx_dma_init()
     };
     enIrqRegistration(&btcIrqConf);
     // note: irq priority should not matter much, as the btc interrupt handler can handle missed interrupts
-    NVIC_SetPriority(btcIrqConf.enIRQn, DDL_IRQ_PRIORITY_03);
+    NVIC_SetPriority(btcIrqConf.enIRQn, IRQ_PRIORITY_USART_DMA);
     NVIC_ClearPendingIRQ(btcIrqConf.enIRQn);
     NVIC_EnableIRQ(btcIrqConf.enIRQn);
 
@@ -394,10 +413,43 @@ Usart::Usart(struct usart_config_t *config, gpio_pin_t tx_pin, gpio_pin_t rx_pin
     this->config = config;
     this->tx_pin = tx_pin;
     this->rx_pin = rx_pin;
-    
+    this->rx_buffer_size = rx_buffer_size;
+    this->tx_buffer_size = tx_buffer_size;
+
+    // with USART_LAZY_BUFFERS, buffers are allocated by the first begin(), so static instances
+    // that are never used do not allocate heap before main()
+    #ifndef USART_LAZY_BUFFERS
+    allocate_buffers();
+    #endif
+}
+
+/**
+ * @brief create a ring buffer, in SRAMH if fast memory sections are enabled
+ */
+static RingBuffer<uint8_t> *new_ring_buffer(const size_t size)
+{
+    #ifdef CORE_RAM_SECTIONS_ENABLE
+    // fall back to the heap once the pool is used up
+    uint8_t *buffer = static_cast<uint8_t *>(core_fast_alloc(size));
+    if (buffer != nullptr)
+    {
+        return new RingBuffer<uint8_t>(buffer, size, /*free_buffer*/ false);
+    }
+    #endif
+
+    return new RingBuffer<uint8_t>(size);
+}
+
+void Usart::allocate_buffers()
+{
+    if (this->rxBuffer != nullptr)
+    {
+        return;
+    }
+
     // initialize and assign rx and tx buffers
-    this->rxBuffer = new RingBuffer<uint8_t>(rx_buffer_size);
-    this->txBuffer = new RingBuffer<uint8_t>(tx_buffer_size);
+    this->rxBuffer = new_ring_buffer(this->rx_buffer_size);
+    this->txBuffer = new_ring_buffer(this->tx_buffer_size);
     CORE_ASSERT(this->rxBuffer != nullptr, "");
     CORE_ASSERT(this->txBuffer != nullptr, "");
 
@@ -490,6 +542,9 @@ void Usart::begin(uint32_t baud, uint16_t config)
 
 void Usart::begin(uint32_t baud, const stc_usart_uart_init_t *config, const bool rxNoiseFilter)
 {
+    // allocate buffers on first use
+    allocate_buffers();
+
     // clear rx and tx buffers
     this->rxBuffer->clear();
     this->txBuffer->clear();
@@ -501,12 +556,11 @@ void Usart::begin(uint32_t baud, const stc_usart_uart_init_t *config, const bool
     // enable peripheral clock
     PWC_Fcg1PeriphClockCmd(this->config->peripheral.clock_id, Enable);
 
-    // initialize usart peripheral and set baud rate
-    USART_UART_Init(this->config->peripheral.register_base, config);
-    SetUartBaudrate(this->config->peripheral.register_base, baud);
-
-    // set noise filtering on RX line
-    USART_FuncCmd(this->config->peripheral.register_base, UsartNoiseFilter, rxNoiseFilter ? Enable : Disable);
+    // initialize usart peripheral, set baud rate and noise filtering on RX line
+    this->uart_config = *config;
+    this->baudrate = baud;
+    this->rx_noise_filter = rxNoiseFilter;
+    apply_uart_config();
 
     // setup usart interrupts
     usart_irq_register(this->config->interrupts.rx_error, "usart rx error");
@@ -531,11 +585,55 @@ void Usart::begin(uint32_t baud, const stc_usart_uart_init_t *config, const bool
     USART_FuncCmd(this->config->peripheral.register_base, UsartRx, Enable);
     USART_FuncCmd(this->config->peripheral.register_base, UsartRxInt, Enable);
 
+    // re-apply the baud rate when the clocks change
+    this->clock_listener = {
+        .pre_change = on_clock_pre_change,
+        .post_change = on_clock_post_change,
+        .arg = this,
+        .next = nullptr,
+    };
+    sysclock_add_listener(&this->clock_listener);
+
     // write debug message AFTER init (this UART may be used for the debug message)
     USART_DEBUG_PRINTF("begin completed\n");
     this->initialized = true;
 }
 
+void Usart::apply_uart_config()
+{
+    USART_UART_Init(this->config->peripheral.register_base, &this->uart_config);
+    SetUartBaudrate(this->config->peripheral.register_base, this->baudrate);
+    USART_FuncCmd(this->config->peripheral.register_base, UsartNoiseFilter, this->rx_noise_filter ? Enable : Disable);
+}
+
+void Usart::on_clock_pre_change(void *arg)
+{
+    // finish sending at the old baud rate
+    static_cast<Usart *>(arg)->flush();
+}
+
+void Usart::on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks)
+{
+    Usart *usart = static_cast<Usart *>(arg);
+    if (!usart->initialized || old_clocks->pclk1 == SYSTEM_CLOCK_FREQUENCIES.pclk1)
+    {
+        return;
+    }
+
+    #ifdef USART_AUTO_CLKDIV_OS_CONFIG
+    // the best clock divider and oversampling mode depend on PCLK1
+    setCalculatedClockDivAndOversampling(&usart->uart_config, usart->baudrate);
+    #endif
+
+    // re-initialize with the new clock, then enable RX again as in begin()
+    // (tx is enabled on-demand when data is available to send)
+    M4_USART_TypeDef *base = usart->config->peripheral.register_base;
+    USART_FuncCmd(base, UsartRx, Disable);
+    usart->apply_uart_config();
+    USART_FuncCmd(base, UsartRx, Enable);
+    USART_FuncCmd(base, UsartRxInt, Enable);
+}
+
 void Usart::end()
 {
     // write debug message BEFORE deinit (this UART may be used for the debug message)
@@ -543,6 +641,7 @@ void Usart::end()
 
     // wait for tx buffer to empty
     flush();
+    sysclock_remove_listener(&this->clock_listener);
 
     // clear initialized flag early so write() ignores calls 
     // and doesn't try to wait for tx buffer to empty
@@ -576,32 +675,51 @@ void Usart::end()
     // disable peripheral clock
     PWC_Fcg1PeriphClockCmd(this->config->peripheral.clock_id, Disable);
 
-    // clear rx and tx buffers
-    this->rxBuffer->clear();
-    this->txBuffer->clear();
+    // clear rx and tx buffers, if allocated
+    if (this->rxBuffer != nullptr)
+    {
+        this->rxBuffer->clear();
+        this->txBuffer->clear();
+    }
 
     this->initialized = false;
 }
 
 int Usart::available(void)
 {
+    // buffers may not be allocated before begin()
+    if (this->rxBuffer == nullptr)
+    {
+        return 0;
+    }
+
     return this->rxBuffer->count();
 }
 
 int Usart::availableForWrite(void)
 {
+    if (this->txBuffer == nullptr)
+    {
+        return 0;
+    }
+
     return this->txBuffer->capacity() - this->txBuffer->count();
 }
 
 int Usart::peek(void)
 {
+    if (this->rxBuffer == nullptr)
+    {
+        return -1;
+    }
+
     return this->rxBuffer->peek();
 }
 
 int Usart::read(void)
 {
     uint8_t ch;
-    if (this->rxBuffer->pop(ch))
+    if (this->rxBuffer != nullptr && this->rxBuffer->pop(ch))
     {
         return ch;
     }
@@ -619,10 +737,11 @@ void Usart::flush(void)
         return;
     }
 
-    // wait for tx buffer to empty
+    // wait for tx buffer to empty. the tx interrupt ends the idle wait
     while (!this->txBuffer->isEmpty())
     {
         yield();
+        CORE_IDLE_WAIT();
     }
 }
 
@@ -634,10 +753,11 @@ size_t Usart::write(uint8_t ch)
         return 1;
     }
 
-    // wait until tx buffer is no longer full
+    // wait until tx buffer is no longer full. the tx interrupt ends the idle wait
     while (this->txBuffer->isFull())
     {
         yield();
+        CORE_IDLE_WAIT();
     }
 
     // add to tx buffer
@@ -653,6 +773,30 @@ size_t Usart::write(uint8_t ch)
     return 1;
 }
 
+bool Usart::WriteOperation::poll()
+{
+    // like write(), ignore if not initialized
+    if (!this->usart->initialized)
+    {
+        this->written = this->size;
+        return true;
+    }
+
+    // only write what fits, so write() never blocks
+    while (this->written < this->size && this->usart->availableForWrite() > 0)
+    {
+        this->usart->write(this->buffer[this->written]);
+        this->written++;
+    }
+
+    return this->written >= this->size;
+}
+
+bool Usart::FlushOperation::poll()
+{
+    return !this->usart->initialized || this->usart->txBuffer->isEmpty();
+}
+
 const usart_receive_error_t Usart::getReceiveError()
 {
     auto rxError = this->config->state.rx_error;
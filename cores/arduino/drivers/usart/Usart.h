@@ -18,9 +18,11 @@
 
 #pragma once
 #include <stdint.h>
+#include <string.h>
 #include "HardwareSerial.h"
 #include "RingBuffer.h"
 #include "usart_config.h"
+#include "../sysclock/sysclock_change.h"
 #include "../../core_types.h"
 
 #ifndef SERIAL_BUFFER_SIZE
@@ -65,6 +67,47 @@ public:
   using Print::write; // pull in write(str) and write(buf, size) from Print
   operator bool() { return true; }
 
+  /**
+   * @brief pending write, returned by writeAsync()
+   * @note poll() returns true once all bytes are in the tx buffer. result() is the number of bytes written
+   */
+  struct WriteOperation
+  {
+    Usart *usart;
+    const uint8_t *buffer;
+    size_t size;
+    size_t written;
+
+    bool poll();
+    size_t result() const { return this->written; }
+  };
+
+  /**
+   * @brief pending flush, returned by flushAsync()
+   * @note poll() returns true once the tx buffer is empty
+   */
+  struct FlushOperation
+  {
+    Usart *usart;
+
+    bool poll();
+  };
+
+  /**
+   * @brief write without blocking. the buffer is copied to the tx buffer as space becomes available
+   * @param buffer data to write. must stay valid until the operation completes
+   * @param size number of bytes to write
+   * @note use with co_await (see core_async.h), or poll the operation manually
+   */
+  WriteOperation writeAsync(const uint8_t *buffer, size_t size) { return WriteOperation{this, buffer, size, 0}; }
+  WriteOperation writeAsync(const char *str) { return writeAsync(reinterpret_cast<const uint8_t *>(str), strlen(str)); }
+
+  /**
+   * @brief wait for the tx buffer to empty, without blocking
+   * @note use with co_await (see core_async.h), or poll the operation manually
+   */
+  FlushOperation flushAsync() { return FlushOperation{this}; }
+
   /**
    * @brief access the base usart config struct
    */
@@ -132,8 +175,26 @@ private:
   gpio_pin_t rx_pin;
 
   // rx / tx buffers (unboxed from config)
-  RingBuffer<uint8_t> *rxBuffer;
-  RingBuffer<uint8_t> *txBuffer;
+  RingBuffer<uint8_t> *rxBuffer = nullptr;
+  RingBuffer<uint8_t> *txBuffer = nullptr;
+
+  // rx / tx buffer sizes, for allocation on first use
+  size_t rx_buffer_size;
+  size_t tx_buffer_size;
+
+  void allocate_buffers();
+
+  // uart configuration and baud rate, to re-apply after a clock change
+  stc_usart_uart_init_t uart_config;
+  uint32_t baudrate;
+  bool rx_noise_filter;
+
+  // clock change listener, registered while initialized
+  sysclock_listener_t clock_listener;
+
+  void apply_uart_config();
+  static void on_clock_pre_change(void *arg);
+  static void on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks);
 
   // is initialized? (begin() called)
   bool initialized = false;
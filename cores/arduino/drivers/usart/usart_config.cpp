@@ -21,6 +21,7 @@ usart_config_t USART1_config = {
         .rx_error = {
             .interrupt_source = INT_USART1_EI,
             .interrupt_handler = USARTx_rx_error_irq<1>,
+            .interrupt_pending = USARTx_rx_error_pending<1>,
         },
         .tx_buffer_empty = {
             .interrupt_source = INT_USART1_TI,
@@ -29,6 +30,7 @@ usart_config_t USART1_config = {
         .tx_complete = {
             .interrupt_source = INT_USART1_TCI,
             .interrupt_handler = USARTx_tx_complete_irq<1>,
+            .interrupt_pending = USARTx_tx_complete_pending<1>,
         },
     },
     .state = {
@@ -59,6 +61,7 @@ usart_config_t USART2_config = {
         .rx_error = {
             .interrupt_source = INT_USART2_EI,
             .interrupt_handler = USARTx_rx_error_irq<2>,
+            .interrupt_pending = USARTx_rx_error_pending<2>,
         },
         .tx_buffer_empty = {
             .interrupt_source = INT_USART2_TI,
@@ -67,6 +70,7 @@ usart_config_t USART2_config = {
         .tx_complete = {
             .interrupt_source = INT_USART2_TCI,
             .interrupt_handler = USARTx_tx_complete_irq<2>,
+            .interrupt_pending = USARTx_tx_complete_pending<2>,
         },
     },
     .state = {
@@ -97,6 +101,7 @@ usart_config_t USART3_config = {
         .rx_error = {
             .interrupt_source = INT_USART3_EI,
             .interrupt_handler = USARTx_rx_error_irq<3>,
+            .interrupt_pending = USARTx_rx_error_pending<3>,
         },
         .tx_buffer_empty = {
             .interrupt_source = INT_USART3_TI,
@@ -105,6 +110,7 @@ usart_config_t USART3_config = {
         .tx_complete = {
             .interrupt_source = INT_USART3_TCI,
             .interrupt_handler = USARTx_tx_complete_irq<3>,
+            .interrupt_pending = USARTx_tx_complete_pending<3>,
         },
     },
     .state = {
@@ -135,6 +141,7 @@ usart_config_t USART4_config = {
         .rx_error = {
             .interrupt_source = INT_USART4_EI,
             .interrupt_handler = USARTx_rx_error_irq<4>,
+            .interrupt_pending = USARTx_rx_error_pending<4>,
         },
         .tx_buffer_empty = {
             .interrupt_source = INT_USART4_TI,
@@ -143,6 +150,7 @@ usart_config_t USART4_config = {
         .tx_complete = {
             .interrupt_source = INT_USART4_TCI,
             .interrupt_handler = USARTx_tx_complete_irq<4>,
+            .interrupt_pending = USARTx_tx_complete_pending<4>,
         },
     },
     .state = {
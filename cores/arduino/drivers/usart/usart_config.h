@@ -49,6 +49,13 @@ struct usart_interrupt_config_t
      * @brief Interrupt handler function pointer
      */
     func_ptr_t interrupt_handler;
+
+    /**
+     * @brief check if the interrupt has work for the handler
+     * @note if set, the interrupt is registered on a shared IRQ instead of a dedicated one
+     * @note see shared_irq_pending_t in interrupts.h
+     */
+    bool (*interrupt_pending)(void);
 };
 
 /**
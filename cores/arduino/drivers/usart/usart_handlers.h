@@ -1,5 +1,6 @@
 #include "usart_config.h"
 #include "../../core_hooks.h"
+#include "../../core_sections.h"
 
 #define USART_COUNT 4
 usart_config_t *USARTx[USART_COUNT] = {
@@ -12,9 +13,12 @@ usart_config_t *USARTx[USART_COUNT] = {
 //
 // IRQ handler implementations
 //
+// the handlers that run for every byte, and their IRQ handler templates, are CORE_RAMFUNC, so they run from SRAMH if
+// fast memory sections are enabled
+//
 
 #ifdef USART_RX_DMA_SUPPORT
-static void USART_rx_dma_btc_irq(uint8_t x)
+CORE_RAMFUNC static void USART_rx_dma_btc_irq(uint8_t x)
 {
     usart_config_t *usartx = USARTx[x - 1];
 
@@ -102,7 +106,7 @@ static void USART_rx_dma_btc_irq(uint8_t x)
 }
 #endif // USART_RX_DMA_SUPPORT
 
-static void USART_rx_data_available_irq(uint8_t x)
+CORE_RAMFUNC static void USART_rx_data_available_irq(uint8_t x)
 {
     usart_config_t *usartx = USARTx[x - 1];
 
@@ -160,7 +164,7 @@ static void USART_rx_error_irq(uint8_t x)
     }
 }
 
-static void USART_tx_buffer_empty_irq(uint8_t x)
+CORE_RAMFUNC static void USART_tx_buffer_empty_irq(uint8_t x)
 {
     usart_config_t *usartx = USARTx[x - 1];
 
@@ -199,7 +203,7 @@ static void USART_tx_complete_irq(uint8_t x)
 
 #if USART_RX_DMA_SUPPORT
 template <uint8_t x>
-static void USARTx_rx_da_dma_btc_irq(void)
+CORE_RAMFUNC static void USARTx_rx_da_dma_btc_irq(void)
 {
     ASSERT_VALID_USARTx(x);
     USART_rx_dma_btc_irq(x);
@@ -207,7 +211,7 @@ static void USARTx_rx_da_dma_btc_irq(void)
 #endif // USART_RX_DMA_SUPPORT
 
 template <uint8_t x>
-static void USARTx_rx_data_available_irq(void)
+CORE_RAMFUNC static void USARTx_rx_data_available_irq(void)
 {
     ASSERT_VALID_USARTx(x);
     USART_rx_data_available_irq(x);
@@ -221,7 +225,7 @@ static void USARTx_rx_error_irq(void)
 }
 
 template <uint8_t x>
-static void USARTx_tx_buffer_empty_irq(void)
+CORE_RAMFUNC static void USARTx_tx_buffer_empty_irq(void)
 {
     ASSERT_VALID_USARTx(x);
     USART_tx_buffer_empty_irq(x);
@@ -233,3 +237,27 @@ static void USARTx_tx_complete_irq(void)
     ASSERT_VALID_USARTx(x);
     USART_tx_complete_irq(x);
 }
+
+//
+// shared IRQ pending checks
+//
+
+template <uint8_t x>
+static bool USARTx_rx_error_pending(void)
+{
+    ASSERT_VALID_USARTx(x);
+    M4_USART_TypeDef *usart = USARTx[x - 1]->peripheral.register_base;
+    return USART_GetStatus(usart, UsartFrameErr) == Set ||
+           USART_GetStatus(usart, UsartParityErr) == Set ||
+           USART_GetStatus(usart, UsartOverrunErr) == Set;
+}
+
+template <uint8_t x>
+static bool USARTx_tx_complete_pending(void)
+{
+    ASSERT_VALID_USARTx(x);
+    M4_USART_TypeDef *usart = USARTx[x - 1]->peripheral.register_base;
+
+    // the TC flag is set whenever the transmitter is idle, so it only counts while the interrupt is enabled
+    return usart->CR1_f.TCIE == 1 && USART_GetStatus(usart, UsartTxComplete) == Set;
+}
@@ -0,0 +1,170 @@
+#include "edge_capture.h"
+#include "WInterrupts.h"
+#include "wiring_constants.h"
+#include "core_debug.h"
+#include "core_critical.h"
+#include "drivers/dwt/dwt.h"
+#include "drivers/gpio/gpio_port.h"
+#include <hc32_ddl.h>
+
+static_assert((EDGE_CAPTURE_BUFFER_SIZE & (EDGE_CAPTURE_BUFFER_SIZE - 1)) == 0, "EDGE_CAPTURE_BUFFER_SIZE must be a power of two");
+
+/**
+ * @brief edge capture configuration of a EXTI channel
+ */
+typedef struct edge_capture_channel_t
+{
+    /**
+     * @brief pin the channel captures
+     */
+    gpio_pin_t pin;
+
+    /**
+     * @brief input register (PIDR) address and mask of the pin
+     */
+    uint32_t input_register;
+    uint16_t mask;
+
+    /**
+     * @brief sample the pin level after each edge (CHANGE mode)?
+     */
+    bool sample_level;
+
+    /**
+     * @brief level of all edges, if not sampled
+     */
+    uint8_t level;
+} edge_capture_channel_t;
+
+static edge_capture_channel_t capture_channels[16];
+
+//
+// event ring buffer
+// written by the interrupt handlers, read by the application
+//
+static edge_event_t capture_buffer[EDGE_CAPTURE_BUFFER_SIZE];
+static volatile uint32_t capture_head = 0;
+static volatile uint32_t capture_tail = 0;
+static volatile uint32_t capture_overruns = 0;
+
+/**
+ * @brief EXTI channel interrupt handler, records a edge event
+ * @tparam CH EXTI channel number
+ */
+template <uint8_t CH>
+static void edge_capture_irq(void)
+{
+    const uint32_t timestamp = dwt_get_cycles();
+    const edge_capture_channel_t &channel = capture_channels[CH];
+    const uint8_t level = channel.sample_level
+                              ? ((gpio::port_register(channel.input_register) & channel.mask) != 0 ? 1 : 0)
+                              : channel.level;
+
+    // clear EXTI channel flag
+    M4_INTC->EICFR = (1ul << CH);
+
+    // capture interrupts may preempt each other if their priorities differ,
+    // so pushing is done with interrupts disabled. this is only a few instructions
+    const critical_state_t critical_state = critical_section_enter(0);
+
+    const uint32_t head = capture_head;
+    if ((head - capture_tail) >= EDGE_CAPTURE_BUFFER_SIZE)
+    {
+        capture_overruns = capture_overruns + 1;
+    }
+    else
+    {
+        edge_event_t &event = capture_buffer[head & (EDGE_CAPTURE_BUFFER_SIZE - 1)];
+        event.timestamp = timestamp;
+        event.pin = channel.pin;
+        event.level = level;
+        capture_head = head + 1;
+    }
+
+    critical_section_exit(critical_state);
+}
+
+static const voidFuncPtr EDGE_CAPTURE_HANDLERS[16] = {
+    edge_capture_irq<0>,
+    edge_capture_irq<1>,
+    edge_capture_irq<2>,
+    edge_capture_irq<3>,
+    edge_capture_irq<4>,
+    edge_capture_irq<5>,
+    edge_capture_irq<6>,
+    edge_capture_irq<7>,
+    edge_capture_irq<8>,
+    edge_capture_irq<9>,
+    edge_capture_irq<10>,
+    edge_capture_irq<11>,
+    edge_capture_irq<12>,
+    edge_capture_irq<13>,
+    edge_capture_irq<14>,
+    edge_capture_irq<15>,
+};
+
+int attachEdgeCapture(gpio_pin_t pin, uint32_t mode)
+{
+    ASSERT_GPIO_PIN_VALID(pin, "attachEdgeCapture", return -1);
+    CORE_ASSERT(mode == RISING || mode == FALLING || mode == CHANGE, "attachEdgeCapture: mode must be RISING, FALLING or CHANGE", return -1);
+
+    // the timestamps require the cycle counter
+    if (!dwt_is_enabled())
+    {
+        dwt_init();
+    }
+
+    // EXTI channel equals the bit position of the pin
+    const gpio::pin_description_t description = gpio::describe_pin(pin);
+    const uint8_t ch = description.bit_pos;
+
+    // with interrupts disabled, edges that occur during attach are handled once the channel config is set
+    const critical_state_t critical_state = critical_section_enter(0);
+
+    const int irqn = attachInterrupt(pin, EDGE_CAPTURE_HANDLERS[ch], mode);
+    if (irqn >= 0)
+    {
+        edge_capture_channel_t &channel = capture_channels[ch];
+        channel.pin = pin;
+        channel.input_register = gpio::port_register_address(description.port, gpio::PIDR_OFFSET);
+        channel.mask = description.mask();
+        channel.sample_level = mode == CHANGE;
+        channel.level = mode == RISING ? 1 : 0;
+    }
+
+    critical_section_exit(critical_state);
+    return irqn;
+}
+
+size_t edgeCaptureAvailable()
+{
+    return capture_head - capture_tail;
+}
+
+size_t edgeCaptureRead(edge_event_t *events, const size_t max_count)
+{
+    CORE_ASSERT(events != nullptr, "edgeCaptureRead: events is nullptr", return 0);
+
+    const uint32_t head = capture_head;
+    uint32_t tail = capture_tail;
+    size_t n = 0;
+    while (tail != head && n < max_count)
+    {
+        events[n++] = capture_buffer[tail & (EDGE_CAPTURE_BUFFER_SIZE - 1)];
+        tail++;
+    }
+
+    // release the slots only after they were copied
+    capture_tail = tail;
+    return n;
+}
+
+uint32_t edgeCaptureOverruns()
+{
+    return capture_overruns;
+}
+
+void edgeCaptureClearOverruns()
+{
+    capture_overruns = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "edge_decode.h"
+
+/**
+ * edge timestamp capture for external interrupts.
+ *
+ * instead of calling a user callback, the external interrupt handler records every edge as a
+ * edge_event_t (pin, level, DWT cycle counter timestamp) into a lock-free ring buffer.
+ * the application drains the buffer with edgeCaptureRead() and decodes the events in batch,
+ * e.g. using the helpers in edge_decode.h.
+ *
+ * the timestamp is taken as the first instruction of the interrupt handler, so it does not depend
+ * on the time spent in other parts of the handler.
+ */
+
+/**
+ * @brief number of events the capture buffer can hold
+ * @note must be a power of two
+ */
+#ifndef EDGE_CAPTURE_BUFFER_SIZE
+#define EDGE_CAPTURE_BUFFER_SIZE 64
+#endif
+
+/**
+ * @brief start capturing edges on a pin
+ * @param pin the pin to capture edges on
+ * @param mode RISING, FALLING or CHANGE
+ * @return assigned interrupt number, or -1 if the interrupt couldn't be assigned
+ * @note uses attachInterrupt() internally, so the same limitations apply.
+ *       call detachInterrupt() to stop capturing.
+ * @note with RISING or FALLING, the level of the events is implied by the mode.
+ *       with CHANGE, the level is sampled right after the timestamp.
+ */
+int attachEdgeCapture(gpio_pin_t pin, uint32_t mode);
+
+/**
+ * @brief get the number of captured events waiting to be read
+ */
+size_t edgeCaptureAvailable();
+
+/**
+ * @brief read captured events, oldest first
+ * @param events buffer for the events
+ * @param max_count size of the events buffer
+ * @return number of events read
+ */
+size_t edgeCaptureRead(edge_event_t *events, const size_t max_count);
+
+/**
+ * @brief get the number of events dropped because the capture buffer was full
+ */
+uint32_t edgeCaptureOverruns();
+
+/**
+ * @brief reset the overrun counter
+ */
+void edgeCaptureClearOverruns();
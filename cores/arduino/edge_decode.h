@@ -0,0 +1,252 @@
+#pragma once
+#include <stddef.h>
+#include "core_types.h"
+
+/**
+ * decode helpers for captured edge events.
+ *
+ * these functions process edge events recorded by attachEdgeCapture() in batch, outside of interrupt context.
+ * they only depend on the events themselves, so decoders may be fed from any source.
+ */
+
+/**
+ * @brief a edge on a pin, recorded by the edge capture
+ */
+typedef struct edge_event_t
+{
+    /**
+     * @brief DWT cycle counter value when the edge occurred
+     * @note wraps around at 2^32. use edge_cycles_between() to calculate differences
+     */
+    uint32_t timestamp;
+
+    /**
+     * @brief pin the edge occurred on
+     */
+    gpio_pin_t pin;
+
+    /**
+     * @brief level of the pin after the edge. 1 for a rising edge, 0 for a falling edge
+     */
+    uint8_t level;
+} edge_event_t;
+
+/**
+ * @brief a pulse decoded from two consecutive edges
+ */
+typedef struct edge_pulse_t
+{
+    /**
+     * @brief level of the pin during the pulse
+     */
+    uint8_t level;
+
+    /**
+     * @brief length of the pulse, in CPU cycles
+     */
+    uint32_t cycles;
+} edge_pulse_t;
+
+/**
+ * @brief state of a pulse decoder
+ * @note initialize using edge_pulse_decoder_init()
+ */
+typedef struct edge_pulse_decoder_t
+{
+    /**
+     * @brief pin to decode pulses of
+     */
+    gpio_pin_t pin;
+
+    /**
+     * @brief is last valid?
+     */
+    bool has_last;
+
+    /**
+     * @brief last edge on the pin
+     */
+    edge_event_t last;
+} edge_pulse_decoder_t;
+
+/**
+ * @brief state of a quadrature decoder
+ * @note initialize using edge_quadrature_decoder_init()
+ */
+typedef struct edge_quadrature_decoder_t
+{
+    /**
+     * @brief pins of the A and B channel
+     */
+    gpio_pin_t pin_a;
+    gpio_pin_t pin_b;
+
+    /**
+     * @brief current levels, (A << 1) | B
+     */
+    uint8_t state;
+
+    /**
+     * @brief accumulated position, in quadrature steps (4 per encoder cycle)
+     */
+    int32_t position;
+
+    /**
+     * @brief number of events that did not change the level of their channel
+     * @note caused by missed edges, e.g. on capture buffer overruns. the position may be off after a error
+     */
+    uint32_t errors;
+} edge_quadrature_decoder_t;
+
+/**
+ * @brief get the number of cycles between two edges
+ * @param from the earlier edge
+ * @param to the later edge
+ * @note correct across a single wrap of the cycle counter
+ */
+inline uint32_t edge_cycles_between(const edge_event_t &from, const edge_event_t &to)
+{
+    return to.timestamp - from.timestamp;
+}
+
+/**
+ * @brief convert CPU cycles to microseconds
+ * @param cycles cycles to convert
+ * @param cpu_frequency CPU frequency, in Hz. e.g. SYSTEM_CLOCK_FREQUENCIES.system
+ */
+inline uint32_t edge_cycles_to_us(const uint32_t cycles, const uint32_t cpu_frequency)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(cycles) * 1000000ull) / cpu_frequency);
+}
+
+/**
+ * @brief initialize a pulse decoder
+ * @param decoder the decoder to initialize
+ * @param pin the pin to decode pulses of. events of other pins are ignored
+ */
+inline void edge_pulse_decoder_init(edge_pulse_decoder_t &decoder, const gpio_pin_t pin)
+{
+    decoder.pin = pin;
+    decoder.has_last = false;
+}
+
+/**
+ * @brief feed a edge event to a pulse decoder
+ * @param decoder the decoder
+ * @param event the event. events must be fed in the order they were captured
+ * @param pulse the pulse that ended with this event
+ * @return true if the event completed a pulse
+ * @note if the event has the same level as the previous one, a edge was missed.
+ *       the decoder then restarts from this event instead of reporting a wrong pulse.
+ */
+inline bool edge_pulse_decode(edge_pulse_decoder_t &decoder, const edge_event_t &event, edge_pulse_t &pulse)
+{
+    if (event.pin != decoder.pin)
+    {
+        return false;
+    }
+
+    const bool valid = decoder.has_last && decoder.last.level != event.level;
+    if (valid)
+    {
+        pulse.level = decoder.last.level;
+        pulse.cycles = edge_cycles_between(decoder.last, event);
+    }
+
+    decoder.last = event;
+    decoder.has_last = true;
+    return valid;
+}
+
+/**
+ * @brief decode all pulses in a batch of edge events
+ * @param decoder the decoder
+ * @param events the events, in the order they were captured
+ * @param count number of events
+ * @param pulses buffer for the decoded pulses
+ * @param max_pulses size of the pulses buffer
+ * @return number of pulses written to the buffer
+ * @note stops early if the pulses buffer is full. the remaining events are not consumed by the decoder
+ */
+inline size_t edge_pulse_decode_all(edge_pulse_decoder_t &decoder,
+                                    const edge_event_t *events,
+                                    const size_t count,
+                                    edge_pulse_t *pulses,
+                                    const size_t max_pulses)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count && n < max_pulses; i++)
+    {
+        if (edge_pulse_decode(decoder, events[i], pulses[n]))
+        {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief initialize a quadrature decoder
+ * @param decoder the decoder to initialize
+ * @param pin_a pin of the A channel
+ * @param pin_b pin of the B channel
+ * @param level_a current level of the A channel, e.g. digitalRead(pin_a)
+ * @param level_b current level of the B channel, e.g. digitalRead(pin_b)
+ */
+inline void edge_quadrature_decoder_init(edge_quadrature_decoder_t &decoder,
+                                         const gpio_pin_t pin_a,
+                                         const gpio_pin_t pin_b,
+                                         const bool level_a,
+                                         const bool level_b)
+{
+    decoder.pin_a = pin_a;
+    decoder.pin_b = pin_b;
+    decoder.state = static_cast<uint8_t>((level_a ? 2 : 0) | (level_b ? 1 : 0));
+    decoder.position = 0;
+    decoder.errors = 0;
+}
+
+/**
+ * @brief feed a edge event to a quadrature decoder
+ * @param decoder the decoder
+ * @param event the event. events of pins other than A and B are ignored
+ * @return position change caused by the event. -1, 0 or +1
+ * @note A leading B counts up
+ */
+inline int8_t edge_quadrature_decode(edge_quadrature_decoder_t &decoder, const edge_event_t &event)
+{
+    uint8_t next;
+    if (event.pin == decoder.pin_a)
+    {
+        next = static_cast<uint8_t>((decoder.state & 1) | (event.level ? 2 : 0));
+    }
+    else if (event.pin == decoder.pin_b)
+    {
+        next = static_cast<uint8_t>((decoder.state & 2) | (event.level ? 1 : 0));
+    }
+    else
+    {
+        return 0;
+    }
+
+    // index = (previous state << 2) | next state
+    // gray code sequence counting up: 00 -> 10 -> 11 -> 01 -> 00
+    constexpr int8_t STEP[16] = {
+        0, -1, +1, 0,
+        +1, 0, 0, -1,
+        -1, 0, 0, +1,
+        0, +1, -1, 0};
+
+    // a edge that doesn't change the level means the opposite edge was missed
+    if (next == decoder.state)
+    {
+        decoder.errors++;
+    }
+
+    const int8_t step = STEP[(decoder.state << 2) | next];
+
+    decoder.state = next;
+    decoder.position += step;
+    return step;
+}
@@ -0,0 +1,55 @@
+#include "boot_profile.h"
+
+#ifdef CORE_BOOT_PROFILE_ENABLE
+#include "../drivers/dwt/dwt.h"
+#include "../Print.h"
+#include <stdio.h>
+
+static boot_profile_mark_t marks[BOOT_PROFILE_MAX_MARKS];
+static uint32_t mark_count = 0;
+
+/**
+ * @brief start the cycle counter before any other static constructor runs
+ * @note priority 101 is the first one available to applications
+ */
+__attribute__((constructor(101))) static void boot_profile_start(void)
+{
+    dwt_init();
+    DWT->CYCCNT = 0;
+    boot_profile_mark("start");
+}
+
+void boot_profile_mark(const char *name)
+{
+    if (mark_count >= BOOT_PROFILE_MAX_MARKS)
+    {
+        return;
+    }
+
+    marks[mark_count].name = name;
+    marks[mark_count].cycles = dwt_get_cycles();
+    mark_count++;
+}
+
+const boot_profile_mark_t *boot_profile_get_marks(uint32_t *count)
+{
+    *count = mark_count;
+    return marks;
+}
+
+void boot_profile_dump(Print &out)
+{
+    out.println("stage                 cycles      total");
+    for (uint32_t i = 0; i < mark_count; i++)
+    {
+        const uint32_t duration = i > 0 ? marks[i].cycles - marks[i - 1].cycles : 0;
+
+        char line[64];
+        snprintf(line, sizeof(line), "%-20s %10lu %10lu",
+                 marks[i].name,
+                 static_cast<unsigned long>(duration),
+                 static_cast<unsigned long>(marks[i].cycles));
+        out.println(line);
+    }
+}
+#endif // CORE_BOOT_PROFILE_ENABLE
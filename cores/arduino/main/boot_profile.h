@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * boot profiler.
+ *
+ * when CORE_BOOT_PROFILE_ENABLE is defined, the core records the DWT cycle counter at every stage of the boot
+ * sequence: static constructors, each step of core_init() and setup(). the counter is reset and started by
+ * the first static constructor, so all marks are relative to the start of the static constructors.
+ *
+ * the first mark, "start", is the reference point. every following mark ends the stage of its name.
+ * the marks are printed to the debug output after setup(), and can be printed using boot_profile_dump().
+ * applications can add their own marks using BOOT_PROFILE_MARK().
+ *
+ * @note marks are in CPU cycles. the CPU clock changes during the boot sequence (e.g. in the sysclock_init
+ *       hook), so the duration of early stages is in cycles of the default 8 MHz clock
+ */
+
+/**
+ * @brief maximum number of recorded marks. further marks are ignored
+ */
+#ifndef BOOT_PROFILE_MAX_MARKS
+#define BOOT_PROFILE_MAX_MARKS 24
+#endif
+
+#ifdef CORE_BOOT_PROFILE_ENABLE
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief a boot stage
+     */
+    typedef struct boot_profile_mark_t
+    {
+        /**
+         * @brief name of the stage that ended at this mark
+         */
+        const char *name;
+
+        /**
+         * @brief DWT cycle counter at the end of the stage
+         */
+        uint32_t cycles;
+    } boot_profile_mark_t;
+
+    /**
+     * @brief record the end of a boot stage
+     * @param name name of the stage. must be a string literal or otherwise stay valid
+     */
+    void boot_profile_mark(const char *name);
+
+    /**
+     * @brief get the recorded marks
+     * @param count number of marks
+     * @return the marks, in the order they were recorded
+     */
+    const boot_profile_mark_t *boot_profile_get_marks(uint32_t *count);
+
+#ifdef __cplusplus
+}
+
+class Print;
+
+/**
+ * @brief print the recorded marks, with the duration of each stage
+ * @param out where to print to, e.g. Serial
+ */
+void boot_profile_dump(Print &out);
+#endif
+
+#define BOOT_PROFILE_MARK(name) boot_profile_mark(name)
+#else
+#define BOOT_PROFILE_MARK(name)
+#endif // CORE_BOOT_PROFILE_ENABLE
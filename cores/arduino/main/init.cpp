@@ -1,9 +1,13 @@
 #include "init.h"
+#include "boot_profile.h"
 #include "../drivers/sysclock/sysclock.h"
 #include "../drivers/sysclock/sysclock_util.h"
 #include "../drivers/sysclock/systick.h"
 #include "../drivers/panic/fault_handlers.h"
 #include "../drivers/interrupts/interrupts.h"
+#include "../drivers/dwt/dwt.h"
+#include "../drivers/deferred/deferred.h"
+#include "../drivers/scheduler/scheduler.h"
 #include "../core_debug.h"
 #include "../core_hooks.h"
 #include <hc32_ddl.h>
@@ -36,33 +40,55 @@ void core_init()
     SCB->CPACR |= 0x00F00000;
 #endif
 
+    // enable DWT cycle counter for cycle-accurate timestamps and delays.
+    // done first, so delays in the hooks below work
+    dwt_init();
+
     // setup vector table offset
     SCB->VTOR = (uint32_t(LD_FLASH_START) & SCB_VTOR_TBLOFF_Msk);
+    BOOT_PROFILE_MARK("vector_table");
 
     // check if last reset could be reoccuring
     check_reoccuring_reset_fault();
+    BOOT_PROFILE_MARK("reset_cause");
 
     // setup fault handling
     fault_handlers_init();
+    BOOT_PROFILE_MARK("fault_handlers");
 
     // initialize system clock:
     // - restore default clock settings
     #if !defined(CORE_DONT_RESTORE_DEFAULT_CLOCKS)
       sysclock_restore_default_clocks();
+      BOOT_PROFILE_MARK("clock_restore");
     #endif
 
     // - call user setup hook
     core_hook_sysclock_init();
     update_system_clock_frequencies();
+    BOOT_PROFILE_MARK("sysclock_init");
 
     // enable flash ICACHE
     #if !defined(CORE_DONT_ENABLE_ICACHE)
       EFM_InstructionCacheCmd(Enable);
+      BOOT_PROFILE_MARK("icache");
     #endif
 
     // initialize interrupts driver and dynamic vector table
     interrupts_init();
+    BOOT_PROFILE_MARK("interrupts");
+
+    // initialize deferred work
+    deferred_init();
+    BOOT_PROFILE_MARK("deferred");
+
+    // initialize the task scheduler
+    #ifdef CORE_SCHEDULER_ENABLE
+      scheduler_init();
+      BOOT_PROFILE_MARK("scheduler");
+    #endif
 
     // initialize systick
     systick_init();
+    BOOT_PROFILE_MARK("systick");
 }
@@ -1,26 +1,46 @@
 #include "../Arduino.h"
 #include "init.h"
+#include "boot_profile.h"
 #include "../core_debug.h"
 #include "../core_hooks.h"
+#include "../core_idle.h"
 
 int main(void)
 {
+	// static constructors ran before main()
+	BOOT_PROFILE_MARK("static_ctors");
+
 	// initialize SoC, then CORE_DEBUG
 	core_init();
 	CORE_DEBUG_INIT();
+	BOOT_PROFILE_MARK("debug_init");
 
 	// call setup()
 	core_hook_pre_setup();
 	CORE_DEBUG_PRINTF("core entering setup\n");
 	setup();
+	BOOT_PROFILE_MARK("setup");
 	core_hook_post_setup();
+
+	#ifdef CORE_BOOT_PROFILE_ENABLE
+	uint32_t mark_count;
+	const boot_profile_mark_t *marks = boot_profile_get_marks(&mark_count);
+	for (uint32_t i = 1; i < mark_count; i++)
+	{
+		CORE_DEBUG_PRINTF("boot: %s took %lu cycles\n", marks[i].name, static_cast<unsigned long>(marks[i].cycles - marks[i - 1].cycles));
+	}
+	#endif
 	
 	// call loop() forever
 	CORE_DEBUG_PRINTF("core entering main loop\n");
 	while (1)
 	{
+		core_loop_stats_update();
 		core_hook_loop();
 		loop();
+
+		// sleep until the next interrupt, if enabled
+		CORE_IDLE_WAIT();
 	}
 
 	CORE_ASSERT_FAIL("main loop exited");
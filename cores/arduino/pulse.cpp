@@ -0,0 +1,213 @@
+#include "pulse.h"
+#include "delay.h"
+#include "yield.h"
+#include "drivers/gpio/gpio_port.h"
+#include "drivers/timera/timera_capture.h"
+#include "core_debug.h"
+
+//
+// pulseIn
+//
+
+/**
+ * @brief measure a pulse using TimerA input capture
+ * @note capture must be running on the channel
+ */
+static uint32_t pulse_in_capture(timera_config_t *unit, const en_timera_channel_t channel, const uint32_t state, const uint32_t timeout)
+{
+    const timera_capture_channel_state_t *capture = timera_capture_get_channel(unit, channel);
+    const bool high = state == HIGH;
+
+    // only pulses that start after this call are measured, just like the software version
+    const uint32_t first_edge = capture->edge_count;
+    const uint32_t start = micros();
+
+    uint32_t ticks;
+    while (timera_capture_read_pulse(capture, high, ticks) <= first_edge)
+    {
+        if ((micros() - start) >= timeout)
+        {
+            return 0;
+        }
+
+        yield();
+    }
+
+    return timera_capture_ticks_to_us(unit, ticks);
+}
+
+/**
+ * @brief measure a pulse by polling the pin input register
+ * @note used for pins without a TimerA assignment
+ */
+static uint32_t pulse_in_software(const gpio_pin_t pin, const uint32_t state, const uint32_t timeout)
+{
+    const GpioPort port = GpioPort::of(pin);
+    const uint16_t mask = gpio::describe_pin(pin).mask();
+    const uint16_t level = (state == HIGH) ? mask : 0;
+    const uint32_t start = micros();
+
+    // wait for any previous pulse to end
+    while ((port.read() & mask) == level)
+    {
+        if ((micros() - start) >= timeout)
+        {
+            return 0;
+        }
+    }
+
+    // wait for the pulse to start
+    while ((port.read() & mask) != level)
+    {
+        if ((micros() - start) >= timeout)
+        {
+            return 0;
+        }
+    }
+
+    // wait for the pulse to end
+    const uint32_t pulse_start = micros();
+    while ((port.read() & mask) == level)
+    {
+        if ((micros() - start) >= timeout)
+        {
+            return 0;
+        }
+    }
+
+    return micros() - pulse_start;
+}
+
+uint32_t pulseIn(gpio_pin_t pin, uint32_t state, uint32_t timeout)
+{
+    ASSERT_GPIO_PIN_VALID(pin, "pulseIn", return 0);
+
+    // use input capture if the pin has a TimerA assignment that is not used for PWM
+    timera_config_t *unit;
+    en_timera_channel_t channel;
+    en_port_func_t function;
+    if (timera_get_assignment(pin, unit, channel, function))
+    {
+        // capture may already be running, e.g. by a PulseCapture on the same pin
+        const bool was_active = timera_capture_is_active(unit, channel);
+        if (was_active || timera_capture_start(unit, channel, pin, function) == Ok)
+        {
+            const uint32_t width = pulse_in_capture(unit, channel, state, timeout);
+            if (!was_active)
+            {
+                timera_capture_stop(unit, channel);
+            }
+
+            return width;
+        }
+    }
+
+    return pulse_in_software(pin, state, timeout);
+}
+
+uint32_t pulseInLong(gpio_pin_t pin, uint32_t state, uint32_t timeout)
+{
+    return pulseIn(pin, state, timeout);
+}
+
+//
+// PulseCapture
+//
+
+bool PulseCapture::begin()
+{
+    ASSERT_GPIO_PIN_VALID(_pin, "PulseCapture::begin", return false);
+    if (_unit != nullptr)
+    {
+        return true;
+    }
+
+    timera_config_t *unit;
+    en_timera_channel_t channel;
+    en_port_func_t function;
+    if (!timera_get_assignment(_pin, unit, channel, function))
+    {
+        CORE_ASSERT_FAIL("PulseCapture::begin: pin has no TimerA assignment");
+        return false;
+    }
+
+    if (timera_capture_start(unit, channel, _pin, function) != Ok)
+    {
+        return false;
+    }
+
+    _unit = unit;
+    _channel = static_cast<uint8_t>(channel);
+    _read_edge = 0;
+    return true;
+}
+
+void PulseCapture::end()
+{
+    if (_unit == nullptr)
+    {
+        return;
+    }
+
+    timera_capture_stop(_unit, static_cast<en_timera_channel_t>(_channel));
+    _unit = nullptr;
+}
+
+bool PulseCapture::available()
+{
+    if (_unit == nullptr)
+    {
+        return false;
+    }
+
+    const timera_capture_channel_state_t *capture = timera_capture_get_channel(_unit, static_cast<en_timera_channel_t>(_channel));
+    return capture->high_start_edge > _read_edge || capture->low_start_edge > _read_edge;
+}
+
+uint32_t PulseCapture::highTime()
+{
+    if (_unit == nullptr)
+    {
+        return 0;
+    }
+
+    uint32_t ticks;
+    const uint32_t edge = timera_capture_read_pulse(timera_capture_get_channel(_unit, static_cast<en_timera_channel_t>(_channel)), true, ticks);
+    if (edge > _read_edge)
+    {
+        _read_edge = edge;
+    }
+
+    return edge == 0 ? 0 : timera_capture_ticks_to_us(_unit, ticks);
+}
+
+uint32_t PulseCapture::lowTime()
+{
+    if (_unit == nullptr)
+    {
+        return 0;
+    }
+
+    uint32_t ticks;
+    const uint32_t edge = timera_capture_read_pulse(timera_capture_get_channel(_unit, static_cast<en_timera_channel_t>(_channel)), false, ticks);
+    if (edge > _read_edge)
+    {
+        _read_edge = edge;
+    }
+
+    return edge == 0 ? 0 : timera_capture_ticks_to_us(_unit, ticks);
+}
+
+uint32_t PulseCapture::period()
+{
+    if (_unit == nullptr)
+    {
+        return 0;
+    }
+
+    const timera_capture_channel_state_t *capture = timera_capture_get_channel(_unit, static_cast<en_timera_channel_t>(_channel));
+    const uint32_t high_edge = capture->high_start_edge;
+    const uint32_t low_edge = capture->low_start_edge;
+    _read_edge = high_edge > low_edge ? high_edge : low_edge;
+    return timera_capture_ticks_to_us(_unit, capture->period_ticks);
+}
@@ -31,9 +31,88 @@ extern "C" {
  */
 uint32_t pulseIn(gpio_pin_t pin, uint32_t state, uint32_t timeout);
 
+/*
+ * \brief Measures the length (in microseconds) of a pulse on the pin; state is HIGH
+ * or LOW, the type of pulse to measure. Same as pulseIn(), provided for compatibility
+ * with the AVR core, where it is the variant that works with interrupts enabled.
+ */
+uint32_t pulseInLong(gpio_pin_t pin, uint32_t state, uint32_t timeout);
+
 #ifdef __cplusplus
 // Provides a version of pulseIn with a default argument (C++ only)
 uint32_t pulseIn(gpio_pin_t pin, uint32_t state, uint32_t timeout = 1000000L);
+uint32_t pulseInLong(gpio_pin_t pin, uint32_t state, uint32_t timeout = 1000000L);
 
 } // extern "C"
+
+/**
+ * @brief continuous, non-blocking pulse measurement using TimerA input capture
+ *
+ * @note only pins with a TimerA assignment (see isAnalogWritePin()) can be used.
+ *       the pin cannot be used for PWM output while the capture is running.
+ *
+ * @example
+ * PulseCapture capture(PA0);
+ * capture.begin();
+ * ...
+ * if (capture.available())
+ * {
+ *   uint32_t high_us = capture.highTime();
+ *   uint32_t period_us = capture.period();
+ * }
+ */
+class PulseCapture
+{
+public:
+  /**
+   * @brief create a pulse capture on a pin
+   * @param pin the pin to measure. must have a TimerA assignment
+   */
+  explicit PulseCapture(gpio_pin_t pin) : _pin(pin) {}
+  ~PulseCapture() { end(); }
+
+  /**
+   * @brief start measuring in the background
+   * @return true on success, false if the pin has no TimerA assignment or the timer unit is in use with a incompatible configuration
+   */
+  bool begin();
+
+  /**
+   * @brief stop measuring
+   */
+  void end();
+
+  /**
+   * @brief was a new pulse measured since highTime(), lowTime() or period() were last called?
+   */
+  bool available();
+
+  /**
+   * @brief width of the last complete high pulse, in microseconds
+   * @return pulse width, or 0 if no high pulse was measured yet
+   */
+  uint32_t highTime();
+
+  /**
+   * @brief width of the last complete low pulse, in microseconds
+   * @return pulse width, or 0 if no low pulse was measured yet
+   */
+  uint32_t lowTime();
+
+  /**
+   * @brief time between the last two rising edges, in microseconds
+   * @return period, or 0 if no period was measured yet
+   */
+  uint32_t period();
+
+private:
+  gpio_pin_t _pin;
+  struct timera_config_t *_unit = nullptr;
+  uint8_t _channel = 0;
+
+  /**
+   * @brief edge index of the newest pulse returned to the user
+   */
+  uint32_t _read_edge = 0;
+};
 #endif
@@ -23,56 +23,132 @@
 #include "wiring_digital.h"
 #include "wiring_private.h"
 #include "core_debug.h"
+#include "drivers/gpio/direct_access.h"
 
 #ifdef __cplusplus
 extern "C"{
 #endif
 
-uint32_t shiftIn( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder )
+// number of cycles to wait after each clock edge.
+// keeps the clock pulse and data setup time within the limits of common shift registers (e.g. 74HC595 at 3.3V)
+#ifndef SHIFT_CLOCK_DELAY_CYCLES
+  #define SHIFT_CLOCK_DELAY_CYCLES 8
+#endif
+
+/**
+ * port registers of the data and clock pin, resolved once per transfer
+ */
+typedef struct
 {
-  ASSERT_GPIO_PIN_VALID( ulDataPin, "shiftIn" ) ;
+  volatile uint16_t *data_set ;
+  volatile uint16_t *data_reset ;
+  volatile uint16_t *data_input ;
+  uint16_t data_mask ;
 
-  uint8_t value = 0 ;
-  uint8_t i ;
+  volatile uint16_t *clock_set ;
+  volatile uint16_t *clock_reset ;
+  uint16_t clock_mask ;
+} shift_pins_t ;
+
+static inline void shift_pins_init( shift_pins_t *pins, gpio_pin_t ulDataPin, gpio_pin_t ulClockPin )
+{
+  const uint8_t data_port = digitalPinToPort( ulDataPin ) ;
+  pins->data_set = portSetRegister( data_port ) ;
+  pins->data_reset = portResetRegister( data_port ) ;
+  pins->data_input = portInputRegister( data_port ) ;
+  pins->data_mask = digitalPinToBitMask( ulDataPin ) ;
+
+  const uint8_t clock_port = digitalPinToPort( ulClockPin ) ;
+  pins->clock_set = portSetRegister( clock_port ) ;
+  pins->clock_reset = portResetRegister( clock_port ) ;
+  pins->clock_mask = digitalPinToBitMask( ulClockPin ) ;
+}
+
+static inline void shift_clock_delay( void )
+{
+  for ( uint32_t i = 0 ; i < SHIFT_CLOCK_DELAY_CYCLES ; i++ )
+  {
+    __NOP() ;
+  }
+}
 
-  for ( i=0 ; i < 8 ; ++i )
+static inline uint8_t shift_in_byte( const shift_pins_t *pins, uint32_t ulBitOrder )
+{
+  uint8_t value = 0 ;
+  for ( uint8_t i = 0 ; i < 8 ; i++ )
   {
-    digitalWrite( ulClockPin, HIGH ) ;
+    *pins->clock_set = pins->clock_mask ;
+    shift_clock_delay() ;
+
+    const uint8_t bit = ( *pins->data_input & pins->data_mask ) != 0 ;
+    value |= bit << ( ulBitOrder == LSBFIRST ? i : ( 7 - i ) ) ;
+
+    *pins->clock_reset = pins->clock_mask ;
+    shift_clock_delay() ;
+  }
+
+  return value ;
+}
 
-    if ( ulBitOrder == LSBFIRST )
+static inline void shift_out_byte( const shift_pins_t *pins, uint32_t ulBitOrder, uint8_t ulVal )
+{
+  for ( uint8_t i = 0 ; i < 8 ; i++ )
+  {
+    const uint8_t bit = ulVal & ( 1 << ( ulBitOrder == LSBFIRST ? i : ( 7 - i ) ) ) ;
+    if ( bit )
     {
-      value |= digitalRead( ulDataPin ) << i ;
+      *pins->data_set = pins->data_mask ;
     }
     else
     {
-      value |= digitalRead( ulDataPin ) << (7 - i) ;
+      *pins->data_reset = pins->data_mask ;
     }
+    shift_clock_delay() ;
 
-    digitalWrite( ulClockPin, LOW ) ;
+    *pins->clock_set = pins->clock_mask ;
+    shift_clock_delay() ;
+    *pins->clock_reset = pins->clock_mask ;
   }
+}
 
+uint32_t shiftIn( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder )
+{
+  uint8_t value = 0 ;
+  shiftInBlock( ulDataPin, ulClockPin, ulBitOrder, &value, 1 ) ;
   return value ;
 }
 
 void shiftOut( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, uint32_t ulVal )
 {
-  ASSERT_GPIO_PIN_VALID( ulDataPin, "shiftOut" ) ;
+  const uint8_t value = (uint8_t)ulVal ;
+  shiftOutBlock( ulDataPin, ulClockPin, ulBitOrder, &value, 1 ) ;
+}
 
-  uint8_t i ;
+void shiftInBlock( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, uint8_t *pData, size_t ulLength )
+{
+  ASSERT_GPIO_PIN_VALID( ulDataPin, "shiftIn", return ) ;
+  ASSERT_GPIO_PIN_VALID( ulClockPin, "shiftIn", return ) ;
 
-  for ( i=0 ; i < 8 ; i++ )
+  shift_pins_t pins ;
+  shift_pins_init( &pins, ulDataPin, ulClockPin ) ;
+
+  for ( size_t i = 0 ; i < ulLength ; i++ )
   {
-    if ( ulBitOrder == LSBFIRST )
-    {
-      digitalWrite( ulDataPin, !!(ulVal & (1 << i)) ) ;
-    }
-    else
-    {
-      digitalWrite( ulDataPin, !!(ulVal & (1 << (7 - i))) ) ;
-    }
+    pData[i] = shift_in_byte( &pins, ulBitOrder ) ;
+  }
+}
+
+void shiftOutBlock( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, const uint8_t *pData, size_t ulLength )
+{
+  ASSERT_GPIO_PIN_VALID( ulDataPin, "shiftOut", return ) ;
+  ASSERT_GPIO_PIN_VALID( ulClockPin, "shiftOut", return ) ;
 
-    digitalWrite( ulClockPin, HIGH ) ;
-    digitalWrite( ulClockPin, LOW ) ;
+  shift_pins_t pins ;
+  shift_pins_init( &pins, ulDataPin, ulClockPin ) ;
+
+  for ( size_t i = 0 ; i < ulLength ; i++ )
+  {
+    shift_out_byte( &pins, ulBitOrder, pData[i] ) ;
   }
 }
 
@@ -20,6 +20,7 @@
 #define _WIRING_SHIFT_
 
 #include <stdint.h>
+#include <stddef.h>
 #include "core_types.h"
 
 #ifdef __cplusplus
@@ -37,6 +38,30 @@ extern uint32_t shiftIn( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t u
  */
 extern void shiftOut( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, uint32_t ulVal ) ;
 
+/**
+ * \brief shift in a block of bytes, one bit at a time.
+ *
+ * \param ulDataPin pin to read each bit from
+ * \param ulClockPin pin to toggle to signal a read from ulDataPin
+ * \param ulBitOrder MSBFIRST or LSBFIRST
+ * \param pData buffer to store the received bytes in
+ * \param ulLength number of bytes to receive
+ *
+ * \note the clock pin is pulsed high before each bit is read, just like shiftIn().
+ */
+extern void shiftInBlock( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, uint8_t *pData, size_t ulLength ) ;
+
+/**
+ * \brief shift out a block of bytes, one bit at a time.
+ *
+ * \param ulDataPin pin to output each bit on
+ * \param ulClockPin pin to toggle once the data pin is set
+ * \param ulBitOrder MSBFIRST or LSBFIRST
+ * \param pData bytes to send
+ * \param ulLength number of bytes to send
+ */
+extern void shiftOutBlock( gpio_pin_t ulDataPin, gpio_pin_t ulClockPin, uint32_t ulBitOrder, const uint8_t *pData, size_t ulLength ) ;
+
 
 #ifdef __cplusplus
 }
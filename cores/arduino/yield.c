@@ -17,9 +17,13 @@
 */
 
 #include "core_hooks.h"
+#include "drivers/deferred/deferred.h"
+#include "drivers/softtimer/soft_timer.h"
+#include "drivers/scheduler/scheduler.h"
 
 /**
- * Empty yield() hook.
+ * Default yield() hook. runs software timers and, without DEFERRED_USE_PENDSV, deferred work, and reloads the watchdog.
+ * With CORE_SCHEDULER_ENABLE, it also switches to the next ready task.
  *
  * This function is intended to be used by library writers to build
  * libraries or sketches that supports cooperative threads.
@@ -29,9 +33,21 @@
  */
 static void __empty()
 {
-    // Empty
+#if !DEFERRED_USE_PENDSV
+    // run deferred work that was posted while interrupts were busy.
+    // with PendSV, only PendSV runs it, so a item posted during the run cannot overtake the others
+    deferred_run();
+#endif
+
+    // run software timer callbacks that were deferred to yield()
+    soft_timer_run_pending();
 
     // wdt reload
     core_hook_yield_wdt_reload();
+
+#ifdef CORE_SCHEDULER_ENABLE
+    // let other tasks run
+    scheduler_yield();
+#endif
 }
 void yield(void) __attribute__((weak, alias("__empty")));
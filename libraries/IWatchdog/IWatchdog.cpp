@@ -2,6 +2,7 @@
 #include "core_debug.h"
 #include "drivers/sysclock/sysclock.h"
 #include "drivers/irqn/irqn.h"
+#include "drivers/interrupts/irq_priority.h"
 #include "core_hooks.h"
 
 //
@@ -144,7 +145,7 @@ inline void register_wdt_callback(const voidFuncPtr callback)
     // register and enable IRQ
     enIrqRegistration(&irq_config);
     NVIC_ClearPendingIRQ(irqn);
-    NVIC_SetPriority(irqn, DDL_IRQ_PRIORITY_DEFAULT);
+    NVIC_SetPriority(irqn, IRQ_PRIORITY_WATCHDOG);
     NVIC_EnableIRQ(irqn);
 }
 
@@ -22,6 +22,45 @@ inline uint32_t round_next_power_of_two(uint32_t v)
     return v;
 }
 
+/**
+ * @brief convert a clock divider to the DDL enum
+ * @param divider the clock divider. must be one of [2, 4, 8, 16, 32, 64, 128, 256]
+ * @param ddl_divider the DDL clock divider
+ * @return true if the divider is valid
+ */
+inline bool clock_divider_to_ddl(const uint16_t divider, en_spi_clk_div_t &ddl_divider)
+{
+    switch(divider)
+    {
+        case 2:
+            ddl_divider = SpiClkDiv2;
+            return true;
+        case 4:
+            ddl_divider = SpiClkDiv4;
+            return true;
+        case 8:
+            ddl_divider = SpiClkDiv8;
+            return true;
+        case 16:
+            ddl_divider = SpiClkDiv16;
+            return true;
+        case 32:
+            ddl_divider = SpiClkDiv32;
+            return true;
+        case 64:
+            ddl_divider = SpiClkDiv64;
+            return true;
+        case 128:
+            ddl_divider = SpiClkDiv128;
+            return true;
+        case 256:
+            ddl_divider = SpiClkDiv256;
+            return true;
+        default:
+            return false;
+    }
+}
+
 SPIClass SPI1(&SPI1_config);
 
 void SPIClass::begin()
@@ -67,17 +106,37 @@ void SPIClass::begin()
     // beginTransaction acts as a wrapper for setClockFrequency and setBitOrder
     // so calling it here just acts as setting the default config
     this->beginTransaction(SPISettings());
+
+    // re-apply the clock frequency when PCLK1 changes
+    this->clock_listener = {
+        .pre_change = nullptr,
+        .post_change = on_clock_post_change,
+        .arg = this,
+        .next = nullptr,
+    };
+    sysclock_add_listener(&this->clock_listener);
 }
 
 void SPIClass::end()
 {
+    sysclock_remove_listener(&this->clock_listener);
     SPI_DeInit(this->config->register_base);
 }
 
-void SPIClass::setClockFrequency(const uint32_t frequency)
+void SPIClass::on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks)
 {
-    // get PCLK1 clock, which is the base clock of the SPI peripherals
-    update_system_clock_frequencies();
+    // transfers are synchronous, so none is in progress while the clocks change
+    SPIClass *spi = static_cast<SPIClass *>(arg);
+    if (spi->clock_frequency != 0 && old_clocks->pclk1 != SYSTEM_CLOCK_FREQUENCIES.pclk1)
+    {
+        // runs with interrupts masked, so only update the divider, without debug output
+        spi->apply_clock_frequency(spi->clock_frequency);
+    }
+}
+
+uint16_t SPIClass::apply_clock_frequency(const uint32_t frequency)
+{
+    // PCLK1 is the base clock of the SPI peripherals
     const uint32_t pclk1 = SYSTEM_CLOCK_FREQUENCIES.pclk1;
 
     // calculate nearest divider to match requested clock frequency
@@ -88,57 +147,44 @@ void SPIClass::setClockFrequency(const uint32_t frequency)
     div = round_next_power_of_two(div);
 
     // ensure bounds
-    if (div < 2) 
+    if (div < 2)
     {
-        CORE_DEBUG_PRINTF("SPI div constrained to 2\n");
         div = 2;
     }
 
     if (div > 256)
     {
-        CORE_DEBUG_PRINTF("SPI div constrained to 256\n");
         div = 256;
     }
 
-    CORE_DEBUG_PRINTF("setting spi div to %d (f_req=%d, f_eff=%d)\n", div, frequency, (pclk1 / div));
-    this->setClockDivider(div);
+    en_spi_clk_div_t ddl_divider;
+    clock_divider_to_ddl(static_cast<uint16_t>(div), ddl_divider);
+    SPI_SetClockDiv(this->config->register_base, ddl_divider);
+    return static_cast<uint16_t>(div);
+}
+
+void SPIClass::setClockFrequency(const uint32_t frequency)
+{
+    update_system_clock_frequencies();
+    const uint16_t div = this->apply_clock_frequency(frequency);
+
+    CORE_DEBUG_PRINTF("setting spi div to %d (f_req=%d, f_eff=%d)\n", div, frequency, (SYSTEM_CLOCK_FREQUENCIES.pclk1 / div));
+    this->clock_frequency = frequency;
 }
 
 void SPIClass::setClockDivider(const uint16_t divider)
 {
     en_spi_clk_div_t ddl_divider;
-    switch(divider)
+    if (!clock_divider_to_ddl(divider, ddl_divider))
     {
-        case 2:
-            ddl_divider = SpiClkDiv2;
-            break;
-        case 4:
-            ddl_divider = SpiClkDiv4;
-            break;
-        case 8:
-            ddl_divider = SpiClkDiv8;
-            break;
-        case 16:
-            ddl_divider = SpiClkDiv16;
-            break;
-        case 32:
-            ddl_divider = SpiClkDiv32;
-            break;
-        case 64:
-            ddl_divider = SpiClkDiv64;
-            break;
-        case 128:
-            ddl_divider = SpiClkDiv128;
-            break;  
-        case 256:
-            ddl_divider = SpiClkDiv256;
-            break;
-        default:
-            CORE_ASSERT_FAIL("Invalid SPI clock divider");
-            return;
+        CORE_ASSERT_FAIL("Invalid SPI clock divider");
+        return;
     }
 
     SPI_SetClockDiv(this->config->register_base, ddl_divider);
+
+    // a divider set directly stays as-is when the clocks change
+    this->clock_frequency = 0;
 }
 
 void SPIClass::setBitOrder(const BitOrder order)
@@ -3,6 +3,7 @@
 
 #include "Arduino.h"
 #include <hc32_ddl.h>
+#include <drivers/sysclock/sysclock_change.h>
 #include "spi_config.h"
 
 // check DDL configuration
@@ -121,6 +122,27 @@ private:
 	gpio_pin_t miso_pin;
 	gpio_pin_t clock_pin;
 
+	/**
+	 * @brief clock frequency requested by setClockFrequency(), re-applied after a clock change.
+	 * @note 0 if the divider was set directly using setClockDivider()
+	 */
+	uint32_t clock_frequency = 0;
+
+	/**
+	 * @brief clock change listener, registered between begin() and end()
+	 */
+	sysclock_listener_t clock_listener;
+
+	static void on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks);
+
+	/**
+	 * @brief set the clock divider closest to a clock frequency, based on the current PCLK1
+	 * @param frequency the requested clock frequency
+	 * @return the clock divider that was set, constrained to [2, 256]
+	 * @note does not print debug output or change clock_frequency, so it is safe to call with interrupts masked
+	 */
+	uint16_t apply_clock_frequency(const uint32_t frequency);
+
 	/**
 	 * @brief synchronously send data_len bits of data
 	 * @param data_len number of bits to send. reconfigures the SPI peripheral to this data length before sending.
@@ -1,5 +1,7 @@
 #include "SoftwareSerial.h"
 #include <drivers/gpio/gpio.h>
+#include <core_critical.h>
+#include <core_sections.h>
 
 #warning "SoftwareSerial on HC32F460 is experimental!"
 
@@ -27,7 +29,18 @@ SoftwareSerial::SoftwareSerial(const gpio_pin_t rx_pin, const gpio_pin_t tx_pin,
     #endif
     rx_pin(rx_pin), tx_pin(tx_pin), invert(invert)
 {
-    this->rx_buffer = new RingBuffer<uint8_t>(SOFTWARE_SERIAL_BUFFER_SIZE);
+    #ifdef CORE_RAM_SECTIONS_ENABLE
+    // place the buffer in SRAMH, falling back to the heap once the pool is used up
+    uint8_t *buffer = static_cast<uint8_t *>(core_fast_alloc(SOFTWARE_SERIAL_BUFFER_SIZE));
+    if (buffer != nullptr)
+    {
+        this->rx_buffer = new RingBuffer<uint8_t>(buffer, SOFTWARE_SERIAL_BUFFER_SIZE, /*free_buffer*/ false);
+    }
+    else
+    #endif
+    {
+        this->rx_buffer = new RingBuffer<uint8_t>(SOFTWARE_SERIAL_BUFFER_SIZE);
+    }
     CORE_ASSERT(this->rx_buffer != nullptr, "");
 }
 
@@ -279,7 +292,7 @@ void SoftwareSerial::set_half_duplex_mode(const bool rx)
 // ISR
 //
 
-void SoftwareSerial::do_rx()
+CORE_RAMFUNC void SoftwareSerial::do_rx()
 {
     // if not enabled, do nothing
     if (!rx_active) return;
@@ -340,7 +353,7 @@ void SoftwareSerial::do_rx()
 
 }
 
-void SoftwareSerial::do_tx()
+CORE_RAMFUNC void SoftwareSerial::do_tx()
 {
     // if not enabled, do nothing
     if (!tx_active) return;
@@ -453,17 +466,15 @@ void SoftwareSerial::do_tx()
 
 /*static*/ void SoftwareSerial::add_listener(SoftwareSerial *listener)
 {
-    // pause timer while modifying listener list to avoid race conditions
-    timer.pause();
-
     ListenerItem *item = new ListenerItem;
     CORE_ASSERT(item != nullptr, "");
-
     item->listener = listener;
-    item->next = listeners;
-    listeners = item;
 
-    timer.resume();
+    // mask the timer interrupt while modifying listener list to avoid race conditions
+    CORE_CRITICAL_SECTION(SOFTWARE_SERIAL_TIMER_PRIORITY, {
+        item->next = listeners;
+        listeners = item;
+    });
 }
 
 /*static*/ void SoftwareSerial::remove_listener(SoftwareSerial *listener)
@@ -474,19 +485,17 @@ void SoftwareSerial::do_tx()
     {
         if (item->listener == listener)
         {
-            // pause timer while modifying listener list to avoid race conditions
-            timer.pause();
-
-            if (prev == nullptr)
-            {
-                listeners = item->next;
-            }
-            else
-            {
-                prev->next = item->next;
-            }
-
-            timer.resume();
+            // mask the timer interrupt while modifying listener list to avoid race conditions
+            CORE_CRITICAL_SECTION(SOFTWARE_SERIAL_TIMER_PRIORITY, {
+                if (prev == nullptr)
+                {
+                    listeners = item->next;
+                }
+                else
+                {
+                    prev->next = item->next;
+                }
+            });
 
             delete item;
             return;
@@ -497,7 +506,7 @@ void SoftwareSerial::do_tx()
     }
 }
 
-/*static*/ void SoftwareSerial::timer_isr()
+CORE_RAMFUNC /*static*/ void SoftwareSerial::timer_isr()
 {
     ListenerItem *item = listeners;
     while (item != nullptr)
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <RingBuffer.h>
 #include <Timer0.h>
+#include <drivers/interrupts/irq_priority.h>
 
 #ifndef SOFTWARE_SERIAL_BUFFER_SIZE
 #define SOFTWARE_SERIAL_BUFFER_SIZE 32
@@ -27,7 +28,7 @@
 #endif
 
 #ifndef SOFTWARE_SERIAL_TIMER_PRIORITY
-#define SOFTWARE_SERIAL_TIMER_PRIORITY 3
+#define SOFTWARE_SERIAL_TIMER_PRIORITY IRQ_PRIORITY_SOFTWARE_SERIAL
 #endif
 
 // changes the way the SoftwareSerial library behaves to match the one from STM32duino.
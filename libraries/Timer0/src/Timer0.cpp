@@ -1,6 +1,7 @@
 #include "Timer0.h"
 #include <drivers/sysclock/sysclock.h>
 #include <drivers/irqn/irqn.h>
+#include <drivers/interrupts/irq_priority.h>
 
 //
 // helpers
@@ -116,9 +117,9 @@ inline void timer0_irq_register(timer0_interrupt_config_t &irq, voidFuncPtr call
         .pfnCallback = callback,
     };
 
-    // register and enable irq with default priority
+    // register and enable irq with the priority from the priority table
     enIrqRegistration(&irqConf);
-    NVIC_SetPriority(irqConf.enIRQn, DDL_IRQ_PRIORITY_DEFAULT);
+    NVIC_SetPriority(irqConf.enIRQn, IRQ_PRIORITY_TIMER0);
     NVIC_ClearPendingIRQ(irqConf.enIRQn);
     NVIC_EnableIRQ(irqConf.enIRQn);
 }
@@ -198,6 +199,40 @@ void Timer0::start(const uint32_t frequency, const uint16_t prescaler)
 
     // start timer channel with config
     start(&channel_config);
+
+    // keep the frequency when PCLK1 changes
+    if (channel_config.Tim0_CounterMode == Tim0_Sync)
+    {
+        this->frequency = frequency;
+        this->prescaler = prescaler;
+        this->clock_listener = {
+            .pre_change = nullptr,
+            .post_change = on_clock_post_change,
+            .arg = this,
+            .next = nullptr,
+        };
+        sysclock_add_listener(&this->clock_listener);
+    }
+}
+
+void Timer0::on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks)
+{
+    Timer0 *timer = static_cast<Timer0 *>(arg);
+    if (!timer->isStarted || timer->frequency == 0 || old_clocks->pclk1 == SYSTEM_CLOCK_FREQUENCIES.pclk1)
+    {
+        return;
+    }
+
+    // CMP = (base_freq / prescaler) / frequency, constrained to 16 bits
+    uint32_t compare = (SYSTEM_CLOCK_FREQUENCIES.pclk1 / uint32_t(timer->prescaler)) / timer->frequency;
+    compare = constrain(compare, 1ul, 0xFFFFul);
+    timer->setCompareValue(uint16_t(compare));
+
+    // if the counter is already past the new compare value, restart the period instead of counting up to 0xFFFF
+    if (timer->getCount() >= compare)
+    {
+        TIMER0_WriteCntReg(timer->config->peripheral.register_base, timer->config->peripheral.channel, 0);
+    }
 }
 
 void Timer0::start(const stc_tim0_base_init_t *channel_config)
@@ -248,6 +283,8 @@ void Timer0::stop()
 
     // reset channel initialized flag early
     this->isStarted = false;
+    this->frequency = 0;
+    sysclock_remove_listener(&this->clock_listener);
 
     // disable timer interrupt
     TIMER0_IntCmd(this->config->peripheral.register_base, this->config->peripheral.channel, Disable);
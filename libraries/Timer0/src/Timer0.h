@@ -12,6 +12,7 @@
 #include "Arduino.h"
 #include <core_debug.h>
 #include <hc32_ddl.h>
+#include <drivers/sysclock/sysclock_change.h>
 #include "timer0_config.h"
 
 /**
@@ -43,6 +44,7 @@ public:
      * @note Timer0 Unit 1 Channel A will use LRC clock (32KHz) instead of PCLK1 (EXPERIMENTAL, might not work properly)
      * @note this function will not automatically start the timer interrupt. call resume() to start the interrupt
      * @note if the channel is already start()-ed, this function will stop the channel first
+     * @note when PCLK1 changes (see sysclock_change.h), the compare value is recomputed to keep the frequency
      */
     void start(const uint32_t frequency, const uint16_t prescaler = 1);
 
@@ -186,4 +188,18 @@ private:
     timer0_channel_config_t *config;
     voidFuncPtr callback;
     bool isStarted = false;
+
+    /**
+     * @brief frequency and prescaler passed to start(), to recompute the compare value after a clock change
+     * @note frequency is 0 if the channel was started with a custom channel config, or is clocked by LRC
+     */
+    uint32_t frequency = 0;
+    uint16_t prescaler = 1;
+
+    /**
+     * @brief clock change listener, registered while started with a frequency
+     */
+    sysclock_listener_t clock_listener;
+
+    static void on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks);
 };
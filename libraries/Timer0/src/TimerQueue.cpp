@@ -0,0 +1,358 @@
+#include "TimerQueue.h"
+#include <core_critical.h>
+#include <drivers/sysclock/sysclock.h>
+
+static_assert(TIMER_QUEUE_MIN_TICKS > 0 && TIMER_QUEUE_MIN_TICKS < 0xFFFF, "TIMER_QUEUE_MIN_TICKS must be in range [1, 0xFFFE]");
+
+/*static*/ TimerQueue *TimerQueue::active = nullptr;
+
+/**
+ * @brief timer0 clock dividers, smallest first
+ */
+static const struct
+{
+    uint16_t divider;
+    en_tim0_clock_div_t div;
+} CLOCK_DIVIDERS[] = {
+    {1, Tim0_ClkDiv0},
+    {2, Tim0_ClkDiv2},
+    {4, Tim0_ClkDiv4},
+    {8, Tim0_ClkDiv8},
+    {16, Tim0_ClkDiv16},
+    {32, Tim0_ClkDiv32},
+    {64, Tim0_ClkDiv64},
+    {128, Tim0_ClkDiv128},
+    {256, Tim0_ClkDiv256},
+    {512, Tim0_ClkDiv512},
+    {1024, Tim0_ClkDiv1024},
+};
+
+/**
+ * @brief convert a number of ticks from one tick frequency to another
+ */
+static uint64_t convert_ticks(const uint64_t ticks, const uint32_t from_frequency, const uint32_t to_frequency)
+{
+    // split, so the multiplication cannot overflow
+    const uint64_t seconds = ticks / from_frequency;
+    const uint64_t remainder = ticks % from_frequency;
+    return (seconds * to_frequency) + ((remainder * to_frequency) / from_frequency);
+}
+
+TimerQueue::TimerQueue(timer0_channel_config_t *config)
+    : timer(config, TimerQueue::timer_isr), config(config)
+{
+}
+
+void TimerQueue::begin()
+{
+    CORE_ASSERT(active == nullptr || active == this, "TimerQueue::begin(): another TimerQueue is already active", return);
+    CORE_ASSERT(!(this->config->peripheral.register_base == M4_TMR01 && this->config->peripheral.channel == Tim0_ChannelA),
+                "TimerQueue::begin(): Timer0 Unit 1 Channel A is not supported", return);
+
+    // use the largest divider that still gives >= 1 MHz, for the longest range at microsecond resolution
+    update_system_clock_frequencies();
+    const uint32_t pclk1 = SYSTEM_CLOCK_FREQUENCIES.pclk1;
+    size_t i = 0;
+    while ((i + 1) < (sizeof(CLOCK_DIVIDERS) / sizeof(CLOCK_DIVIDERS[0])) &&
+           (pclk1 / CLOCK_DIVIDERS[i + 1].divider) >= 1000000)
+    {
+        i++;
+    }
+    this->divider = CLOCK_DIVIDERS[i].divider;
+    this->tick_frequency = pclk1 / this->divider;
+
+    stc_tim0_base_init_t channel_config = {};
+    channel_config.Tim0_CounterMode = Tim0_Sync;
+    channel_config.Tim0_SyncClockSource = Tim0_Pclk1;
+    channel_config.Tim0_AsyncClockSource = Tim0_LRC;
+    channel_config.Tim0_ClockDivision = CLOCK_DIVIDERS[i].div;
+    channel_config.Tim0_CmpValue = 0xFFFF;
+
+    this->base = 0;
+    this->head = nullptr;
+    active = this;
+
+    this->timer.start(&channel_config);
+    this->timer.resume();
+
+    // keep now() and the deadlines in time when the clocks change
+    this->clock_listener = {
+        .pre_change = nullptr,
+        .post_change = on_clock_post_change,
+        .arg = this,
+        .next = nullptr,
+    };
+    sysclock_add_listener(&this->clock_listener);
+}
+
+void TimerQueue::end()
+{
+    if (active != this)
+    {
+        return;
+    }
+
+    sysclock_remove_listener(&this->clock_listener);
+    this->timer.stop();
+    active = nullptr;
+
+    TimerQueueEvent *event = this->head;
+    while (event != nullptr)
+    {
+        event->scheduled = false;
+        event = event->next;
+    }
+    this->head = nullptr;
+}
+
+bool TimerQueue::schedule(TimerQueueEvent &event, const uint32_t delay_us, const uint32_t period_us)
+{
+    CORE_ASSERT(event.callback != nullptr, "TimerQueue::schedule(): callback is null", return false);
+    if (active != this)
+    {
+        return false;
+    }
+
+    CORE_ASSERT(period_us == 0 || us_to_ticks(period_us) >= TIMER_QUEUE_MIN_TICKS, "TimerQueue::schedule(): period too short", return false);
+
+    CORE_CRITICAL_SECTION(0, {
+        if (event.scheduled)
+        {
+            remove(event);
+        }
+
+        event.deadline = now_ticks() + us_to_ticks(delay_us);
+        event.period = us_to_ticks(period_us);
+        insert(event);
+
+        // only the nearest deadline is programmed
+        if (this->head == &event)
+        {
+            program_next();
+        }
+    });
+    return true;
+}
+
+void TimerQueue::cancel(TimerQueueEvent &event)
+{
+    CORE_CRITICAL_SECTION(0, {
+        if (event.scheduled)
+        {
+            remove(event);
+        }
+    });
+
+    // the compare value is left as is. a early match just finds no due event
+}
+
+uint64_t TimerQueue::now()
+{
+    uint64_t ticks;
+    CORE_CRITICAL_SECTION(0, {
+        ticks = now_ticks();
+    });
+
+    return convert_ticks(ticks, this->tick_frequency, 1000000);
+}
+
+//
+// internal
+//
+
+/**
+ * @brief convert the timebase and the deadlines to the new tick frequency
+ * @note called by sysclock_change() with interrupts masked
+ */
+/*static*/ void TimerQueue::on_clock_post_change(void *arg, const system_clock_frequencies_t * /*old_clocks*/)
+{
+    TimerQueue *queue = static_cast<TimerQueue *>(arg);
+    const uint32_t old_frequency = queue->tick_frequency;
+    const uint32_t new_frequency = SYSTEM_CLOCK_FREQUENCIES.pclk1 / queue->divider;
+    if (active != queue || new_frequency == old_frequency)
+    {
+        return;
+    }
+
+    M4_TMR0_TypeDef *reg = queue->config->peripheral.register_base;
+    const en_tim0_channel_t channel = queue->config->peripheral.channel;
+
+    // restart the counter at the current time. a pending match is already included in now
+    const uint64_t now = queue->now_ticks();
+    queue->base = convert_ticks(now, old_frequency, new_frequency);
+    queue->tick_frequency = new_frequency;
+    TIMER0_WriteCntReg(reg, channel, 0);
+    queue->timer.clearInterruptFlag();
+    queue->timer.setCompareValue(0xFFFF);
+
+    // keep the remaining time of every event. converting is monotonic, so the queue stays ordered
+    for (TimerQueueEvent *event = queue->head; event != nullptr; event = event->next)
+    {
+        const uint64_t remaining = event->deadline > now ? event->deadline - now : 0;
+        event->deadline = queue->base + convert_ticks(remaining, old_frequency, new_frequency);
+
+        if (event->period != 0)
+        {
+            event->period = convert_ticks(event->period, old_frequency, new_frequency);
+            if (event->period < TIMER_QUEUE_MIN_TICKS)
+            {
+                event->period = TIMER_QUEUE_MIN_TICKS;
+            }
+        }
+    }
+
+    queue->program_next();
+}
+
+/**
+ * @note interrupts must be masked
+ */
+uint64_t TimerQueue::now_ticks()
+{
+    M4_TMR0_TypeDef *reg = this->config->peripheral.register_base;
+    const en_tim0_channel_t channel = this->config->peripheral.channel;
+
+    uint32_t count = this->timer.getCount();
+    if (TIMER0_GetFlag(reg, channel) == Set)
+    {
+        // counter matched and restarted, but the interrupt did not update base yet
+        count = this->timer.getCount() + TIMER0_GetCmpReg(reg, channel);
+    }
+
+    return this->base + count;
+}
+
+/**
+ * @note interrupts must be masked
+ */
+void TimerQueue::insert(TimerQueueEvent &event)
+{
+    // events with the same deadline run in the order they were scheduled
+    TimerQueueEvent **link = &this->head;
+    while (*link != nullptr && (*link)->deadline <= event.deadline)
+    {
+        link = &(*link)->next;
+    }
+
+    event.next = *link;
+    *link = &event;
+    event.scheduled = true;
+}
+
+/**
+ * @note interrupts must be masked
+ */
+void TimerQueue::remove(TimerQueueEvent &event)
+{
+    TimerQueueEvent **link = &this->head;
+    while (*link != nullptr)
+    {
+        if (*link == &event)
+        {
+            *link = event.next;
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    event.next = nullptr;
+    event.scheduled = false;
+}
+
+/**
+ * @brief program the compare value for the nearest deadline
+ * @note interrupts must be masked
+ */
+void TimerQueue::program_next()
+{
+    M4_TMR0_TypeDef *reg = this->config->peripheral.register_base;
+    const en_tim0_channel_t channel = this->config->peripheral.channel;
+
+    // a pending match is handled by the interrupt, which programs the compare value again
+    const uint32_t count = this->timer.getCount();
+    if (TIMER0_GetFlag(reg, channel) == Set || TIMER0_GetCmpReg(reg, channel) < (count + TIMER_QUEUE_MIN_TICKS))
+    {
+        // the current compare value matches in a moment, so changing it could race with the match
+        return;
+    }
+
+    // without events, keep the timebase running with the longest period
+    uint64_t compare = 0xFFFF;
+    if (this->head != nullptr)
+    {
+        compare = this->head->deadline > this->base ? this->head->deadline - this->base : 0;
+    }
+
+    // due or too close deadlines match as soon as possible
+    if (compare < (count + TIMER_QUEUE_MIN_TICKS))
+    {
+        compare = count + TIMER_QUEUE_MIN_TICKS;
+    }
+
+    if (compare > 0xFFFF)
+    {
+        compare = 0xFFFF;
+    }
+
+    this->timer.setCompareValue(static_cast<uint16_t>(compare));
+}
+
+/**
+ * @brief handle a compare match
+ * @note called from the timer interrupt
+ */
+void TimerQueue::on_compare_match()
+{
+    M4_TMR0_TypeDef *reg = this->config->peripheral.register_base;
+    const en_tim0_channel_t channel = this->config->peripheral.channel;
+
+    // the counter restarted from 0 on the match.
+    // the flag is clear if a clock change already folded the match into base
+    if (TIMER0_GetFlag(reg, channel) == Set)
+    {
+        this->timer.clearInterruptFlag();
+        this->base = this->base + TIMER0_GetCmpReg(reg, channel);
+    }
+
+    for (;;)
+    {
+        TimerQueueEvent *event;
+        CORE_CRITICAL_SECTION(0, {
+            event = this->head;
+            if (event != nullptr && event->deadline <= now_ticks())
+            {
+                remove(*event);
+
+                // reschedule relative to the deadline, so periodic events do not drift
+                if (event->period != 0)
+                {
+                    event->deadline += event->period;
+                    insert(*event);
+                }
+            }
+            else
+            {
+                event = nullptr;
+            }
+
+            program_next();
+        });
+
+        if (event == nullptr)
+        {
+            break;
+        }
+
+        // callbacks run with interrupts enabled, and may schedule or cancel events
+        event->callback(event->arg);
+    }
+}
+
+/*static*/ void TimerQueue::timer_isr()
+{
+    if (active != nullptr)
+    {
+        active->on_compare_match();
+    }
+}
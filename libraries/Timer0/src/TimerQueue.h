@@ -0,0 +1,181 @@
+#pragma once
+#include "Timer0.h"
+#include <drivers/sysclock/sysclock_change.h>
+
+/**
+ * @brief default Timer0 channel used by TimerQueue
+ */
+#ifndef TIMER_QUEUE_DEFAULT_CHANNEL
+#define TIMER_QUEUE_DEFAULT_CHANNEL TIMER02A_config
+#endif
+
+/**
+ * @brief minimum distance between the counter and a new compare value, in timer ticks
+ * @note ensures the counter does not pass the compare value before the write takes effect
+ */
+#ifndef TIMER_QUEUE_MIN_TICKS
+#define TIMER_QUEUE_MIN_TICKS 8
+#endif
+
+/**
+ * @brief a one-shot or periodic event, scheduled on a TimerQueue
+ * @note the event object must stay valid while it is scheduled. events are not copied
+ */
+class TimerQueueEvent
+{
+public:
+    /**
+     * @brief Construct a new TimerQueueEvent
+     * @param callback function to call when the event is due. called from the timer interrupt
+     * @param arg argument passed to the callback
+     */
+    TimerQueueEvent(voidFuncPtrParam callback, void *arg = nullptr)
+        : callback(callback), arg(arg) {}
+
+    TimerQueueEvent(const TimerQueueEvent &) = delete;
+    TimerQueueEvent &operator=(const TimerQueueEvent &) = delete;
+
+    /**
+     * @brief check if the event is currently scheduled
+     */
+    bool isScheduled() const
+    {
+        return this->scheduled;
+    }
+
+private:
+    friend class TimerQueue;
+
+    voidFuncPtrParam callback;
+    void *arg;
+
+    /**
+     * @brief absolute deadline, in timer ticks
+     */
+    uint64_t deadline = 0;
+
+    /**
+     * @brief period, in timer ticks. 0 for one-shot events
+     */
+    uint64_t period = 0;
+
+    /**
+     * @brief next event in the queue, ordered by deadline
+     */
+    TimerQueueEvent *next = nullptr;
+
+    volatile bool scheduled = false;
+};
+
+/**
+ * @brief timer queue on a Timer0 channel
+ *
+ * the channel runs continuously. the compare value is reprogrammed on every match to the distance to the
+ * nearest deadline, so any number of events share a single hardware timer.
+ * the counter period is limited to 16 bits, so far deadlines are reached in multiple steps.
+ *
+ * @note only one TimerQueue can be active at a time
+ * @note on a clock change (see sysclock_change()), the divider is kept and the tick frequency follows PCLK1.
+ *       now() and the pending deadlines are converted to the new tick frequency
+ * @note Timer0 Unit 1 Channel A is not supported, as it only runs from the LRC clock
+ */
+class TimerQueue
+{
+public:
+    /**
+     * @brief Construct a new TimerQueue
+     * @param config Timer0 channel to use
+     */
+    TimerQueue(timer0_channel_config_t *config = &TIMER_QUEUE_DEFAULT_CHANNEL);
+
+    /**
+     * @brief start the timer
+     * @note the tick frequency is the lowest PCLK1 division that is still >= 1 MHz
+     */
+    void begin();
+
+    /**
+     * @brief stop the timer. all scheduled events are cancelled
+     */
+    void end();
+
+    /**
+     * @brief schedule a event
+     * @param event the event to schedule. if already scheduled, it is rescheduled
+     * @param delay_us time until the event is due, in microseconds
+     * @param period_us period for periodic events, in microseconds. 0 for a one-shot event
+     * @return true if the event was scheduled, false if the queue is not running
+     * @note periodic events are rescheduled relative to their deadline, so they do not drift
+     * @note safe to call from interrupt context, including from a event callback
+     */
+    bool schedule(TimerQueueEvent &event, const uint32_t delay_us, const uint32_t period_us = 0);
+
+    /**
+     * @brief cancel a scheduled event
+     * @param event the event to cancel
+     * @note does nothing if the event is not scheduled
+     */
+    void cancel(TimerQueueEvent &event);
+
+    /**
+     * @brief get the time since begin(), in microseconds
+     */
+    uint64_t now();
+
+    /**
+     * @brief get the tick frequency of the timer, in Hz
+     */
+    uint32_t getTickFrequency() const
+    {
+        return this->tick_frequency;
+    }
+
+    /**
+     * @brief set the priority of the timer interrupt, which runs the event callbacks
+     * @param priority priority to set
+     */
+    void setCallbackPriority(const uint32_t priority)
+    {
+        this->timer.setCallbackPriority(priority);
+    }
+
+private:
+    Timer0 timer;
+    timer0_channel_config_t *config;
+    uint32_t tick_frequency = 0;
+    uint16_t divider = 1;
+
+    /**
+     * @brief ticks elapsed up to the last compare match
+     */
+    volatile uint64_t base = 0;
+
+    /**
+     * @brief scheduled events, ordered by deadline
+     */
+    TimerQueueEvent *head = nullptr;
+
+    /**
+     * @brief the active queue, for the interrupt handler
+     */
+    static TimerQueue *active;
+
+    /**
+     * @brief clock change listener, registered while the queue is active
+     */
+    sysclock_listener_t clock_listener;
+
+    static void timer_isr();
+    static void on_clock_post_change(void *arg, const system_clock_frequencies_t *old_clocks);
+
+    uint64_t us_to_ticks(const uint32_t us) const
+    {
+        return (static_cast<uint64_t>(us) * this->tick_frequency) / 1000000ull;
+    }
+
+    uint64_t now_ticks();
+    void insert(TimerQueueEvent &event);
+    void remove(TimerQueueEvent &event);
+    void program_next();
+    void on_compare_match();
+};
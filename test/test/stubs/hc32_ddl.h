@@ -7,15 +7,36 @@ typedef enum {} en_adc_resolution_t;
 typedef enum {} en_adc_data_align_t;
 typedef enum {} en_adc_scan_mode_t;
 
+#define ADC1_IN0 (0u)
+#define ADC1_IN1 (1u)
+#define ADC1_IN2 (2u)
+#define ADC1_IN3 (3u)
+#define ADC12_IN4 (4u)
+#define ADC12_IN5 (5u)
+#define ADC12_IN6 (6u)
+#define ADC12_IN7 (7u)
+#define ADC12_IN8 (8u)
+#define ADC12_IN9 (9u)
+#define ADC12_IN10 (10u)
+#define ADC12_IN11 (11u)
+#define ADC1_IN12 (12u)
+#define ADC1_IN13 (13u)
+#define ADC1_IN14 (14u)
+#define ADC1_IN15 (15u)
+
 typedef uint16_t en_port_t;
 typedef uint16_t en_pin_t;
+enum { PortA = 0, PortB = 1, PortC = 2, PortD = 3, PortE = 4, PortH = 5 };
 typedef enum {} en_port_func_t;
 
 typedef uint16_t IRQn_Type;
 typedef enum {} en_int_src_t;
+typedef enum {} en_event_src_t;
 typedef void (*func_ptr_t)(void);
 
 typedef struct {} M4_USART_TypeDef;
 typedef struct {} stc_usart_uart_init_t;
 
+typedef struct {} stc_clk_sysclk_cfg_t;
+
 #endif // __HC32_DDL_H__
@@ -1 +1,6 @@
-#define BOARD_NR_GPIO_PINS 0
\ No newline at end of file
+#pragma once
+
+// tests that need the real pin map include the variant header before any core header
+#ifndef BOARD_NR_GPIO_PINS
+#define BOARD_NR_GPIO_PINS 0
+#endif
@@ -0,0 +1,177 @@
+#include "../test.h"
+
+static uint32_t fake_millis = 0;
+#define ASYNC_MILLIS() fake_millis
+#include <core_async.h>
+
+/**
+ * operation that completes after a number of polls, and returns a value
+ */
+struct CountdownOperation
+{
+  int polls_left;
+  int value;
+
+  bool poll()
+  {
+    return polls_left-- <= 0;
+  }
+
+  int result()
+  {
+    return value;
+  }
+};
+
+static AsyncTask record_steps(int *steps, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    (*steps)++;
+    co_await async_yield();
+  }
+}
+
+/**
+ * test tasks start on the first run and are destroyed once finished
+ */
+TEST(AsyncExecutor, RunsTasksToCompletion)
+{
+  AsyncExecutor<2> executor;
+  EXPECT_EQ(executor.capacity(), 2u);
+  EXPECT_EQ(executor.count(), 0u);
+
+  int steps = 0;
+  ASSERT_TRUE(executor.spawn(record_steps(&steps, 3)));
+  EXPECT_EQ(steps, 0) << "Task should not start before run()";
+
+  EXPECT_EQ(executor.run(), 1u);
+  EXPECT_EQ(steps, 1);
+
+  size_t rounds = 1;
+  while (executor.run() > 0)
+  {
+    rounds++;
+    ASSERT_LT(rounds, 10u);
+  }
+  EXPECT_EQ(steps, 3);
+  EXPECT_EQ(executor.count(), 0u) << "Finished task should be removed";
+}
+
+/**
+ * test spawn fails when the executor is full, and slots are reused
+ */
+TEST(AsyncExecutor, SpawnWhenFull)
+{
+  AsyncExecutor<1> executor;
+  int steps_a = 0, steps_b = 0;
+  ASSERT_TRUE(executor.spawn(record_steps(&steps_a, 1)));
+  EXPECT_FALSE(executor.spawn(record_steps(&steps_b, 1))) << "Spawn should fail when full";
+  EXPECT_FALSE(executor.spawn(AsyncTask())) << "Spawn should reject invalid tasks";
+
+  while (executor.run() > 0)
+    ;
+  EXPECT_TRUE(executor.spawn(record_steps(&steps_b, 1))) << "Slot should be free after the task finished";
+}
+
+static AsyncTask interleaved(char name, char *log, size_t *pos)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    log[(*pos)++] = name;
+    co_await async_yield();
+  }
+}
+
+/**
+ * test tasks take turns
+ */
+TEST(AsyncExecutor, TasksInterleave)
+{
+  AsyncExecutor<2> executor;
+  char log[8] = {};
+  size_t pos = 0;
+  executor.spawn(interleaved('a', log, &pos));
+  executor.spawn(interleaved('b', log, &pos));
+
+  while (executor.run() > 0)
+    ;
+  EXPECT_STREQ(log, "abab");
+}
+
+static AsyncTask sleeper(bool *woke)
+{
+  co_await async_sleep_ms(10);
+  *woke = true;
+}
+
+/**
+ * test async_sleep_ms waits for the clock
+ */
+TEST(AsyncTask, Sleep)
+{
+  fake_millis = 0xFFFFFFF8; // across the wrap
+  AsyncExecutor<1> executor;
+  bool woke = false;
+  executor.spawn(sleeper(&woke));
+
+  executor.run();
+  fake_millis += 9;
+  executor.run();
+  EXPECT_FALSE(woke) << "Task should still sleep after 9 ms";
+
+  fake_millis += 1;
+  EXPECT_EQ(executor.run(), 0u);
+  EXPECT_TRUE(woke);
+}
+
+static AsyncTask read_value(int *out)
+{
+  *out = co_await CountdownOperation{2, 42};
+}
+
+/**
+ * test operations are polled until complete, and their result is returned
+ */
+TEST(AsyncTask, OperationResult)
+{
+  int value = 0;
+  AsyncTask task = read_value(&value);
+  ASSERT_TRUE(task.valid());
+
+  EXPECT_FALSE(task.poll());
+  EXPECT_FALSE(task.poll());
+  EXPECT_TRUE(task.poll());
+  EXPECT_EQ(value, 42);
+  EXPECT_TRUE(task.done());
+}
+
+static AsyncTask parent(bool *flag, int *child_steps)
+{
+  co_await async_until([flag]() { return *flag; });
+  co_await record_steps(child_steps, 2);
+  *flag = false;
+}
+
+/**
+ * test async_until and awaiting a child task
+ */
+TEST(AsyncTask, UntilAndChildTask)
+{
+  bool flag = false;
+  int child_steps = 0;
+  AsyncTask task = parent(&flag, &child_steps);
+
+  EXPECT_FALSE(task.poll());
+  EXPECT_FALSE(task.poll());
+  EXPECT_EQ(child_steps, 0) << "Task should wait for the predicate";
+
+  flag = true;
+  int polls = 0;
+  while (!task.poll())
+  {
+    ASSERT_LT(++polls, 10);
+  }
+  EXPECT_EQ(child_steps, 2);
+  EXPECT_FALSE(flag);
+}
@@ -0,0 +1,91 @@
+#include "../test.h"
+#include <drivers/deferred/deferred_queue.h>
+
+static void work_a(void *) {}
+static void work_b(void *) {}
+
+/**
+ * test a new queue is empty
+ */
+TEST(DeferredQueue, SmokeTest)
+{
+  DeferredQueue<4> queue;
+  EXPECT_EQ(queue.capacity(), 4u);
+  EXPECT_EQ(queue.count(), 0u);
+
+  deferred_work_t work;
+  EXPECT_FALSE(queue.pop(work)) << "Pop should return false when queue is empty";
+}
+
+/**
+ * test items are returned in the order they were pushed
+ */
+TEST(DeferredQueue, PushPopOrder)
+{
+  DeferredQueue<8> queue;
+  int args[5];
+  for (int i = 0; i < 5; i++)
+  {
+    EXPECT_TRUE(queue.push({work_a, &args[i]}));
+  }
+  EXPECT_EQ(queue.count(), 5u);
+
+  for (int i = 0; i < 5; i++)
+  {
+    deferred_work_t work;
+    ASSERT_TRUE(queue.pop(work));
+    EXPECT_EQ(work.fn, work_a);
+    EXPECT_EQ(work.arg, &args[i]) << "Items should be popped in FIFO order";
+  }
+
+  deferred_work_t work;
+  EXPECT_FALSE(queue.pop(work));
+}
+
+/**
+ * test push fails when the queue is full, without overwriting items
+ */
+TEST(DeferredQueue, Full)
+{
+  DeferredQueue<4> queue;
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.push({work_a, nullptr}));
+  }
+
+  EXPECT_FALSE(queue.push({work_b, nullptr})) << "Push should return false when queue is full";
+  EXPECT_EQ(queue.count(), 4u);
+
+  deferred_work_t work;
+  ASSERT_TRUE(queue.pop(work));
+  EXPECT_EQ(work.fn, work_a);
+
+  // one cell is free again
+  EXPECT_TRUE(queue.push({work_b, nullptr}));
+}
+
+/**
+ * test the queue keeps working when the indices wrap around the cells many times
+ */
+TEST(DeferredQueue, WrapAround)
+{
+  DeferredQueue<4> queue;
+  uintptr_t next_push = 0, next_pop = 0;
+  for (int round = 0; round < 100; round++)
+  {
+    // push 3, pop 2, so the fill level moves around
+    for (int i = 0; i < 3 && queue.count() < 4; i++)
+    {
+      ASSERT_TRUE(queue.push({work_a, reinterpret_cast<void *>(next_push++)}));
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+      deferred_work_t work;
+      ASSERT_TRUE(queue.pop(work));
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(work.arg), next_pop++);
+    }
+  }
+
+  EXPECT_EQ(queue.count(), next_push - next_pop);
+}
@@ -0,0 +1,93 @@
+#include "../test.h"
+#include <edge_decode.h>
+
+/**
+ * test decoding pulses from a sequence of edges
+ */
+TEST(EdgeDecode, Pulses)
+{
+  const edge_event_t events[] = {
+      {.timestamp = 1000, .pin = 5, .level = 1},
+      {.timestamp = 1500, .pin = 5, .level = 0},
+      {.timestamp = 1700, .pin = 6, .level = 1}, // other pin, ignored
+      {.timestamp = 2500, .pin = 5, .level = 1},
+  };
+
+  edge_pulse_decoder_t decoder;
+  edge_pulse_decoder_init(decoder, 5);
+
+  edge_pulse_t pulses[4];
+  ASSERT_EQ(edge_pulse_decode_all(decoder, events, 4, pulses, 4), 2u);
+  EXPECT_EQ(pulses[0].level, 1);
+  EXPECT_EQ(pulses[0].cycles, 500u);
+  EXPECT_EQ(pulses[1].level, 0);
+  EXPECT_EQ(pulses[1].cycles, 1000u);
+}
+
+/**
+ * test pulses across a wrap of the cycle counter and across batches
+ */
+TEST(EdgeDecode, PulsesWrapAround)
+{
+  edge_pulse_decoder_t decoder;
+  edge_pulse_decoder_init(decoder, 1);
+
+  edge_pulse_t pulse;
+  EXPECT_FALSE(edge_pulse_decode(decoder, {.timestamp = 0xFFFFFF00u, .pin = 1, .level = 0}, pulse)) << "first edge";
+  EXPECT_TRUE(edge_pulse_decode(decoder, {.timestamp = 0x00000100u, .pin = 1, .level = 1}, pulse));
+  EXPECT_EQ(pulse.level, 0);
+  EXPECT_EQ(pulse.cycles, 0x200u);
+}
+
+/**
+ * test the pulse decoder resyncs after a missed edge
+ */
+TEST(EdgeDecode, PulsesMissedEdge)
+{
+  edge_pulse_decoder_t decoder;
+  edge_pulse_decoder_init(decoder, 1);
+
+  edge_pulse_t pulse;
+  edge_pulse_decode(decoder, {.timestamp = 100, .pin = 1, .level = 1}, pulse);
+  EXPECT_FALSE(edge_pulse_decode(decoder, {.timestamp = 300, .pin = 1, .level = 1}, pulse)) << "falling edge missed";
+  EXPECT_TRUE(edge_pulse_decode(decoder, {.timestamp = 350, .pin = 1, .level = 0}, pulse));
+  EXPECT_EQ(pulse.cycles, 50u);
+}
+
+/**
+ * test converting cycles to microseconds
+ */
+TEST(EdgeDecode, CyclesToMicroseconds)
+{
+  EXPECT_EQ(edge_cycles_to_us(200, 200000000), 1u);
+  EXPECT_EQ(edge_cycles_to_us(0xFFFFFFFFu, 200000000), 21474836u) << "no overflow for large values";
+}
+
+/**
+ * test quadrature decoding in both directions and error detection
+ */
+TEST(EdgeDecode, Quadrature)
+{
+  constexpr gpio_pin_t A = 2, B = 3;
+  edge_quadrature_decoder_t decoder;
+  edge_quadrature_decoder_init(decoder, A, B, false, false);
+
+  // one full cycle forward: A rises, B rises, A falls, B falls
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = A, .level = 1}), 1);
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = B, .level = 1}), 1);
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = A, .level = 0}), 1);
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = B, .level = 0}), 1);
+  EXPECT_EQ(decoder.position, 4);
+
+  // one step back: B rises first
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = B, .level = 1}), -1);
+  EXPECT_EQ(decoder.position, 3);
+
+  // B rises again without falling in between: missed edge
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = B, .level = 1}), 0);
+  EXPECT_EQ(decoder.errors, 1u);
+
+  // other pins are ignored
+  EXPECT_EQ(edge_quadrature_decode(decoder, {.timestamp = 0, .pin = 9, .level = 0}), 0);
+  EXPECT_EQ(decoder.errors, 1u);
+}
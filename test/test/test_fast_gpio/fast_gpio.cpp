@@ -0,0 +1,68 @@
+// use the real pin map of the generic variant
+#include "../../../variants/generic_hc32f460/variant.h"
+#include "../test.h"
+#include <drivers/gpio/fast_gpio.h>
+#include "../../../variants/generic_hc32f460/variant.cpp"
+
+/**
+ * test the compile-time pin description matches PIN_MAP for every pin
+ */
+TEST(FastGpio, DescriptionMatchesPinMap)
+{
+  for (gpio_pin_t pin = 0; pin < BOARD_NR_GPIO_PINS; pin++)
+  {
+    const gpio::pin_description_t description = gpio::describe_pin(pin);
+    EXPECT_EQ(description.port, PIN_MAP[pin].port) << "port mismatch for pin " << pin;
+    EXPECT_EQ(description.bit_pos, PIN_MAP[pin].bit_pos) << "bit position mismatch for pin " << pin;
+    EXPECT_EQ(description.mask(), PIN_MAP[pin].bit_mask()) << "bit mask mismatch for pin " << pin;
+  }
+}
+
+/**
+ * test register addresses match the layout used by direct_access.h (0x10 bytes per port, starting at M4_PORT)
+ */
+TEST(FastGpio, RegisterAddressesMatchPinMap)
+{
+  for (gpio_pin_t pin = 0; pin < BOARD_NR_GPIO_PINS; pin++)
+  {
+    const uint32_t port_base = 0x40053800ul + (0x10 * PIN_MAP[pin].port);
+    const uint8_t port = gpio::describe_pin(pin).port;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::PIDR_OFFSET), port_base + 0x00) << "PIDR mismatch for pin " << pin;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::PODR_OFFSET), port_base + 0x04) << "PODR mismatch for pin " << pin;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::POER_OFFSET), port_base + 0x06) << "POER mismatch for pin " << pin;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::POSR_OFFSET), port_base + 0x08) << "POSR mismatch for pin " << pin;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::PORR_OFFSET), port_base + 0x0A) << "PORR mismatch for pin " << pin;
+    EXPECT_EQ(gpio::port_register_address(port, gpio::POTR_OFFSET), port_base + 0x0C) << "POTR mismatch for pin " << pin;
+  }
+}
+
+/**
+ * test DigitalPin<> resolves its registers at compile time
+ */
+TEST(FastGpio, DigitalPinIsConstexpr)
+{
+  // PA5: port A, bit 5
+  static_assert(DigitalPin<PA5>::port == 0, "PA5 port");
+  static_assert(DigitalPin<PA5>::mask == (1 << 5), "PA5 mask");
+  static_assert(DigitalPin<PA5>::set_register == 0x40053808ul, "PA5 POSR");
+  static_assert(DigitalPin<PA5>::reset_register == 0x4005380Aul, "PA5 PORR");
+
+  // PH2: port H, bit 2
+  static_assert(DigitalPin<PH2>::port == 5, "PH2 port");
+  static_assert(DigitalPin<PH2>::mask == (1 << 2), "PH2 mask");
+  static_assert(DigitalPin<PH2>::input_register == 0x40053850ul, "PH2 PIDR");
+
+  EXPECT_EQ(DigitalPin<PC13>::mask, PIN_MAP[PC13].bit_mask());
+  EXPECT_EQ(DigitalPin<PC13>::toggle_register, 0x40053800ul + (0x10 * PIN_MAP[PC13].port) + 0x0C);
+}
+
+/**
+ * test bit-band alias address calculation of the output enable register
+ */
+TEST(FastGpio, OutputEnableBitband)
+{
+  // POERA is at 0x40053806, bit 0 alias = 0x42000000 + (0x53806 * 32)
+  EXPECT_EQ(DigitalPin<PA0>::output_enable_bitband, 0x42A700C0ul);
+  EXPECT_EQ(DigitalPin<PA1>::output_enable_bitband, 0x42A700C4ul);
+  EXPECT_EQ(DigitalPin<PB0>::output_enable_bitband, 0x42A700C0ul + (0x10 * 32));
+}
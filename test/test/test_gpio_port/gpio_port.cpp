@@ -0,0 +1,51 @@
+// use the real pin map of the generic variant
+#include "../../../variants/generic_hc32f460/variant.h"
+#include "../test.h"
+#include <drivers/gpio/gpio_port.h>
+
+/**
+ * test building masks from pins on the same port
+ */
+TEST(GpioPort, MaskOfSamePort)
+{
+  const gpio_pin_t pins[] = {PA1, PA3, PA4};
+  uint8_t port = 0xff;
+  uint16_t mask = 0;
+  EXPECT_TRUE(GpioPort::mask_of(pins, 3, port, mask));
+  EXPECT_EQ(port, 0);
+  EXPECT_EQ(mask, (1 << 1) | (1 << 3) | (1 << 4));
+
+  const gpio_pin_t pins_h[] = {PH0, PH2};
+  EXPECT_TRUE(GpioPort::mask_of(pins_h, 2, port, mask));
+  EXPECT_EQ(port, 5);
+  EXPECT_EQ(mask, (1 << 0) | (1 << 2));
+}
+
+/**
+ * test building masks rejects pins on different ports, invalid pins and empty lists
+ */
+TEST(GpioPort, MaskOfRejectsInvalid)
+{
+  uint8_t port;
+  uint16_t mask;
+
+  const gpio_pin_t mixed[] = {PA1, PB1};
+  EXPECT_FALSE(GpioPort::mask_of(mixed, 2, port, mask)) << "pins on different ports";
+
+  const gpio_pin_t invalid[] = {PA1, BOARD_NR_GPIO_PINS};
+  EXPECT_FALSE(GpioPort::mask_of(invalid, 2, port, mask)) << "invalid pin";
+
+  EXPECT_FALSE(GpioPort::mask_of(mixed, 0, port, mask)) << "empty list";
+}
+
+/**
+ * test compile-time pin lists
+ */
+TEST(GpioPort, CompileTimePins)
+{
+  static_assert(GpioPortPins<PC13>::mask() == (1 << 13), "single pin");
+  static_assert(GpioPortPins<PB0, PB1, PB7>::mask() == 0x0083, "multiple pins");
+  static_assert(GpioPortPins<PE15, PE0>::port().number() == 4, "port E");
+  static_assert(GpioPort::of(PD2).number() == 3, "port D");
+  SUCCEED();
+}
@@ -245,3 +245,19 @@ TEST(RingBuffer, GetLastWrittenElements)
 
   delete rb;
 }
+
+/**
+ * test ring buffer uses a external buffer, and does not free it if told so
+ */
+TEST(RingBuffer, ExternalBuffer)
+{
+  static uint8_t storage[4];
+  auto rb = new RingBuffer<uint8_t>(storage, sizeof(storage), /*free_buffer*/ false);
+
+  EXPECT_EQ(rb->capacity(), 4) << "Capacity should be the size of the external buffer";
+  EXPECT_TRUE(rb->push(42)) << "Push should return true when buffer is not full";
+  EXPECT_EQ(storage[0], 42) << "Element should be stored in the external buffer";
+
+  // must not call delete[] on the static storage
+  delete rb;
+}
@@ -0,0 +1,105 @@
+#include "../test.h"
+#include <drivers/softtimer/soft_timer_wheel.h>
+
+static void dummy_callback(void *) {}
+
+static soft_timer_t make_timer()
+{
+  soft_timer_t timer = {};
+  timer.callback = dummy_callback;
+  return timer;
+}
+
+/**
+ * test a timer expires exactly at its tick, and only once
+ */
+TEST(SoftTimerWheel, ExpiresAtTick)
+{
+  SoftTimerWheel<8> wheel;
+  soft_timer_t timer = make_timer();
+  wheel.insert(&timer, 5);
+
+  for (uint32_t now = 0; now < 5; now++)
+  {
+    EXPECT_EQ(wheel.pop_expired(now), nullptr) << "timer should not expire before its tick";
+  }
+
+  EXPECT_EQ(wheel.pop_expired(5), &timer);
+  EXPECT_EQ(wheel.pop_expired(5), nullptr) << "timer should be unlinked after expiring";
+}
+
+/**
+ * test timers of later rounds in the same bucket are skipped
+ */
+TEST(SoftTimerWheel, LaterRoundsSkipped)
+{
+  SoftTimerWheel<8> wheel;
+  soft_timer_t near = make_timer();
+  soft_timer_t far = make_timer();
+  wheel.insert(&far, 3 + 8 * 2);
+  wheel.insert(&near, 3);
+
+  EXPECT_EQ(wheel.pop_expired(3), &near);
+  EXPECT_EQ(wheel.pop_expired(3), nullptr) << "timer of a later round should not expire";
+  EXPECT_EQ(wheel.pop_expired(3 + 8), nullptr);
+  EXPECT_EQ(wheel.pop_expired(3 + 8 * 2), &far);
+}
+
+/**
+ * test all timers expiring at the same tick are returned
+ */
+TEST(SoftTimerWheel, SameTick)
+{
+  SoftTimerWheel<4> wheel;
+  soft_timer_t timers[3] = {make_timer(), make_timer(), make_timer()};
+  for (auto &timer : timers)
+  {
+    wheel.insert(&timer, 10);
+  }
+
+  int expired = 0;
+  while (wheel.pop_expired(10) != nullptr)
+  {
+    expired++;
+  }
+  EXPECT_EQ(expired, 3);
+}
+
+/**
+ * test removing timers from the head, middle and tail of a bucket
+ */
+TEST(SoftTimerWheel, Remove)
+{
+  SoftTimerWheel<4> wheel;
+  soft_timer_t a = make_timer(), b = make_timer(), c = make_timer();
+
+  // all in bucket 1, list order c, b, a
+  wheel.insert(&a, 1);
+  wheel.insert(&b, 1);
+  wheel.insert(&c, 1);
+
+  wheel.remove(&b); // middle
+  wheel.remove(&c); // head
+  EXPECT_EQ(wheel.pop_expired(1), &a);
+  EXPECT_EQ(wheel.pop_expired(1), nullptr);
+
+  wheel.insert(&a, 5);
+  wheel.insert(&b, 5);
+  wheel.remove(&a); // tail
+  EXPECT_EQ(wheel.pop_expired(5), &b);
+  EXPECT_EQ(wheel.pop_expired(5), nullptr);
+}
+
+/**
+ * test expiry ticks that wrap around 2^32
+ */
+TEST(SoftTimerWheel, TickWrapAround)
+{
+  SoftTimerWheel<8> wheel;
+  soft_timer_t timer = make_timer();
+  const uint32_t now = 0xFFFFFFFEu;
+  wheel.insert(&timer, now + 4); // wraps to 2
+
+  EXPECT_EQ(wheel.pop_expired(now + 1), nullptr);
+  EXPECT_EQ(wheel.pop_expired(2), &timer);
+}
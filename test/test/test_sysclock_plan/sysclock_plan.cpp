@@ -0,0 +1,208 @@
+#include "../test.h"
+#include <drivers/sysclock/sysclock_plan.h>
+
+/**
+ * supported XTAL frequencies
+ */
+static const uint32_t XTALS[] = {4000000, 8000000, 12000000, 16000000, 20000000, 24000000, 25000000};
+
+/**
+ * check a plan against the clock tree rules, independently of the planner
+ */
+static void expect_legal(const sysclock_plan_t &plan, const sysclock_plan_targets_t &targets)
+{
+  ASSERT_TRUE(plan.valid);
+
+  // MPLL bounds
+  EXPECT_GE(plan.mpll_m, 1u);
+  EXPECT_LE(plan.mpll_m, 24u);
+  EXPECT_GE(plan.mpll_n, 20u);
+  EXPECT_LE(plan.mpll_n, 480u);
+  EXPECT_GE(plan.mpll_p, 2u);
+  EXPECT_LE(plan.mpll_p, 16u);
+  const double vco_in = double(plan.input_clock) / plan.mpll_m;
+  const double vco_out = vco_in * plan.mpll_n;
+  EXPECT_GE(vco_in, 1e6);
+  EXPECT_LE(vco_in, 25e6);
+  EXPECT_GE(vco_out, 240e6);
+  EXPECT_LE(vco_out, 480e6);
+  EXPECT_EQ(plan.clocks.system, uint32_t(vco_out / plan.mpll_p));
+
+  // clock frequencies match the dividers
+  const system_clock_frequencies_t &c = plan.clocks;
+  EXPECT_EQ(c.hclk, c.system >> plan.hclk_div);
+  EXPECT_EQ(c.pclk0, c.system >> plan.pclk0_div);
+  EXPECT_EQ(c.pclk1, c.system >> plan.pclk1_div);
+  EXPECT_EQ(c.pclk2, c.system >> plan.pclk2_div);
+  EXPECT_EQ(c.pclk3, c.system >> plan.pclk3_div);
+  EXPECT_EQ(c.pclk4, c.system >> plan.pclk4_div);
+  EXPECT_EQ(c.exclk, c.system >> plan.exclk_div);
+
+  // maximum frequencies
+  EXPECT_LE(c.system, 200000000u);
+  EXPECT_LE(c.hclk, 200000000u);
+  EXPECT_LE(c.pclk0, 200000000u);
+  EXPECT_LE(c.pclk1, 100000000u);
+  EXPECT_LE(c.pclk2, 60000000u);
+  EXPECT_LE(c.pclk3, 50000000u);
+  EXPECT_LE(c.pclk4, 100000000u);
+  EXPECT_LE(c.exclk, 100000000u);
+
+  // clock rules
+  EXPECT_GE(c.hclk, c.pclk1);
+  EXPECT_GE(c.hclk, c.pclk3);
+  EXPECT_GE(c.hclk, c.pclk4);
+  EXPECT_GE(plan.exclk_div, plan.hclk_div + 1) << "HCLK / EXCLK must be at least 2";
+  EXPECT_LE(plan.exclk_div, plan.hclk_div + 5) << "HCLK / EXCLK must be at most 32";
+  EXPECT_GE(c.pclk0, c.pclk1);
+  EXPECT_GE(c.pclk0, c.pclk3);
+  EXPECT_GE(int(plan.pclk4_div) - int(plan.pclk2_div), -2) << "PCLK2 / PCLK4 must be at least 1/4";
+  EXPECT_LE(int(plan.pclk4_div) - int(plan.pclk2_div), 3) << "PCLK2 / PCLK4 must be at most 8";
+
+  // targets are upper bounds
+  const auto bound = [](const uint32_t target) { return target == 0 ? UINT32_MAX : target; };
+  EXPECT_LE(c.hclk, bound(targets.hclk));
+  EXPECT_LE(c.pclk0, bound(targets.pclk0));
+  EXPECT_LE(c.pclk1, bound(targets.pclk1));
+  EXPECT_LE(c.pclk2, bound(targets.pclk2));
+  EXPECT_LE(c.pclk3, bound(targets.pclk3));
+  EXPECT_LE(c.pclk4, bound(targets.pclk4));
+  EXPECT_LE(c.exclk, bound(targets.exclk));
+
+  // wait cycles
+  EXPECT_EQ(plan.flash_wait_cycles, sysclock_plan_flash_wait_cycles(c.hclk));
+  EXPECT_EQ(plan.sram_wait_cycles, c.hclk > 100000000 ? 1u : 0u);
+}
+
+/**
+ * test the plan is computed at compile time
+ */
+TEST(SysclockPlan, Constexpr)
+{
+  constexpr sysclock_plan_t plan = sysclock_plan(8000000, {.hclk = 200000000});
+  static_assert(plan.valid, "plan should be valid");
+  static_assert(plan.clocks.hclk == 200000000, "HCLK should be 200 MHz");
+  SUCCEED();
+}
+
+/**
+ * test the default 200 MHz configuration runs every clock at its maximum
+ */
+TEST(SysclockPlan, MaximumClocks)
+{
+  const sysclock_plan_targets_t targets = {};
+  const sysclock_plan_t plan = sysclock_plan(8000000, targets);
+  expect_legal(plan, targets);
+
+  EXPECT_EQ(plan.clocks.system, 200000000u);
+  EXPECT_EQ(plan.clocks.hclk, 200000000u);
+  EXPECT_EQ(plan.clocks.pclk0, 200000000u);
+  EXPECT_EQ(plan.clocks.pclk1, 100000000u);
+  EXPECT_EQ(plan.clocks.pclk2, 50000000u);
+  EXPECT_EQ(plan.clocks.pclk3, 50000000u);
+  EXPECT_EQ(plan.clocks.pclk4, 100000000u);
+  EXPECT_EQ(plan.clocks.exclk, 100000000u);
+  EXPECT_EQ(plan.flash_wait_cycles, 5u);
+  EXPECT_EQ(plan.sram_wait_cycles, 1u);
+}
+
+/**
+ * test every HCLK target over the legal range gives a legal plan, for every XTAL
+ */
+TEST(SysclockPlan, LegalEnvelope)
+{
+  for (const uint32_t xtal : XTALS)
+  {
+    for (uint32_t hclk = 1000000; hclk <= 200000000; hclk += 1000000)
+    {
+      const sysclock_plan_targets_t targets = {.hclk = hclk};
+      const sysclock_plan_t plan = sysclock_plan(xtal, targets);
+      SCOPED_TRACE(testing::Message() << "xtal=" << xtal << ", hclk=" << hclk);
+      expect_legal(plan, targets);
+
+      // the lowest system clock the MPLL can output is 240 MHz / 16, and HCLK can be divided by up to 64
+      EXPECT_GE(plan.clocks.hclk, hclk / 2) << "HCLK should be close to the target";
+    }
+  }
+}
+
+/**
+ * test whole MHz HCLK targets are reached exactly with a 8 MHz XTAL, without dividing HCLK
+ */
+TEST(SysclockPlan, ExactWithCommonXtal)
+{
+  for (uint32_t mhz = 15; mhz <= 200; mhz++)
+  {
+    const sysclock_plan_t plan = sysclock_plan(8000000, {.hclk = mhz * 1000000});
+    ASSERT_TRUE(plan.valid) << "hclk=" << mhz << " MHz";
+    EXPECT_EQ(plan.clocks.hclk, mhz * 1000000) << "hclk=" << mhz << " MHz";
+    EXPECT_EQ(plan.hclk_div, 0) << "hclk=" << mhz << " MHz";
+  }
+
+  // below 15 MHz, HCLK is divided from the lowest matching system clock
+  const sysclock_plan_t plan = sysclock_plan(8000000, {.hclk = 10000000});
+  EXPECT_EQ(plan.clocks.hclk, 10000000u);
+  EXPECT_EQ(plan.clocks.system, 20000000u);
+}
+
+/**
+ * test peripheral targets are honored, and the PCLK2 / PCLK4 ratio is kept
+ */
+TEST(SysclockPlan, PeripheralTargets)
+{
+  const sysclock_plan_targets_t targets = {
+      .hclk = 168000000,
+      .pclk0 = 84000000,
+      .pclk1 = 42000000,
+      .pclk2 = 3000000,
+      .pclk3 = 21000000,
+      .exclk = 10000000,
+  };
+  const sysclock_plan_t plan = sysclock_plan(8000000, targets);
+  expect_legal(plan, targets);
+
+  EXPECT_EQ(plan.clocks.hclk, 168000000u);
+  EXPECT_EQ(plan.clocks.pclk0, 84000000u);
+  EXPECT_EQ(plan.clocks.pclk1, 42000000u);
+  EXPECT_EQ(plan.clocks.pclk2, 2625000u);
+  EXPECT_EQ(plan.clocks.pclk3, 21000000u);
+  EXPECT_EQ(plan.clocks.pclk4, 10500000u) << "PCLK4 should be slowed down to 4x PCLK2";
+  EXPECT_EQ(plan.clocks.exclk, 5250000u);
+  EXPECT_EQ(plan.flash_wait_cycles, 4u);
+}
+
+/**
+ * test out-of-range inputs give a invalid plan
+ */
+TEST(SysclockPlan, Invalid)
+{
+  EXPECT_FALSE(sysclock_plan(3000000, {}).valid) << "XTAL below 4 MHz";
+  EXPECT_FALSE(sysclock_plan(26000000, {}).valid) << "XTAL above 25 MHz";
+  EXPECT_FALSE(sysclock_plan(8000000, {.hclk = 100000}).valid) << "HCLK below 15 MHz / 64";
+}
+
+/**
+ * test HCLK is lowered if a peripheral target cannot be reached with the highest system clock
+ */
+TEST(SysclockPlan, LowersHclkForSlowPeripheral)
+{
+  const sysclock_plan_targets_t targets = {.hclk = 200000000, .pclk1 = 1000000};
+  const sysclock_plan_t plan = sysclock_plan(8000000, targets);
+  expect_legal(plan, targets);
+  EXPECT_EQ(plan.clocks.hclk, 64000000u) << "PCLK1 = HCLK / 64 should be the highest HCLK";
+}
+
+/**
+ * test the flash wait cycles follow the table of the user manual
+ */
+TEST(SysclockPlan, FlashWaitCycles)
+{
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(8000000), 0u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(33000000), 0u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(33000001), 1u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(66000000), 1u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(99000000), 2u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(132000000), 3u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(168000000), 4u);
+  EXPECT_EQ(sysclock_plan_flash_wait_cycles(200000000), 5u);
+}
@@ -0,0 +1,64 @@
+#include "../test.h"
+#include <drivers/sysclock/timebase_util.h>
+
+/**
+ * systick reload values (ticks per ms) of common system clocks
+ */
+static const uint32_t TICKS_PER_MS[] = {8000, 16000, 100000, 120000, 168000, 200000};
+
+/**
+ * test converting systick ticks to microseconds is within 1 µs of the exact value,
+ * monotonic, and never reaches a full millisecond
+ */
+TEST(TimebaseUtil, TicksToMicroseconds)
+{
+  for (const uint32_t ticks_per_ms : TICKS_PER_MS)
+  {
+    const uint32_t reciprocal = timebase_reciprocal(1000, ticks_per_ms);
+    uint32_t last = 0;
+    for (uint32_t elapsed = 0; elapsed < ticks_per_ms; elapsed++)
+    {
+      const uint32_t us = timebase_scale(elapsed, reciprocal);
+      const uint32_t exact = (elapsed * 1000) / ticks_per_ms;
+
+      ASSERT_GE(us, exact) << "ticks_per_ms=" << ticks_per_ms << ", elapsed=" << elapsed;
+      ASSERT_LE(us, exact + 1) << "ticks_per_ms=" << ticks_per_ms << ", elapsed=" << elapsed;
+      ASSERT_GE(us, last) << "result should be monotonic";
+      ASSERT_LT(us, 1000u) << "result should stay below 1 ms";
+      last = us;
+    }
+  }
+}
+
+/**
+ * test converting nanoseconds to cycles never gives less than the exact value
+ */
+TEST(TimebaseUtil, NanosecondsToCycles)
+{
+  const uint32_t HCLK[] = {8000000, 50000000, 168000000, 200000000};
+  const uint32_t NS[] = {0, 1, 5, 10, 37, 100, 999, 1000, 123456, 1000000, 4000000000u};
+  for (const uint32_t hclk : HCLK)
+  {
+    const uint32_t reciprocal = timebase_reciprocal(hclk, 1000000000ul);
+    for (const uint32_t ns : NS)
+    {
+      const uint64_t exact_num = static_cast<uint64_t>(ns) * hclk;
+      const uint64_t exact_ceil = (exact_num + 999999999ull) / 1000000000ull;
+      const uint32_t cycles = timebase_scale_ceil(ns, reciprocal);
+
+      EXPECT_GE(cycles, exact_ceil) << "delay must not be shorter than requested. hclk=" << hclk << ", ns=" << ns;
+      EXPECT_LE(cycles, exact_ceil + 1) << "hclk=" << hclk << ", ns=" << ns;
+    }
+  }
+}
+
+/**
+ * test the reciprocal is evaluated at compile time
+ */
+TEST(TimebaseUtil, Constexpr)
+{
+  constexpr uint32_t reciprocal = timebase_reciprocal(1, 2);
+  static_assert(reciprocal == 0x80000000u, "1/2 should be 0.5");
+  static_assert(timebase_scale(10, reciprocal) == 5, "10 * 1/2 should be 5");
+  static_assert(timebase_scale_ceil(11, reciprocal) == 6, "11 * 1/2 should round up to 6");
+}
@@ -138,6 +138,32 @@ if not isfile(ddl_build_script):
 
 SConscript(ddl_build_script)
 
+# core_ram_sections is a optional board option that places CORE_RAMFUNC, CORE_FAST_DATA and CORE_FAST_BSS in SRAMH
+# it can be enabled in platformio.ini using 'board_build.core_ram_sections = true'
+# the sections are added to the linker script of the ddl using ld/core_sections.ld, which must come after it
+if str(board.get("build.core_ram_sections", "false")).lower() in ("true", "yes", "1"):
+    if not env.get("LDSCRIPT_PATH", ""):
+        sys.stderr.write("Error: core_ram_sections requires LDSCRIPT_PATH to be set by the ddl build script")
+        env.Exit(1)
+
+    print("Using fast memory sections (core_ram_sections)")
+    env.Append(
+        CPPDEFINES=[
+            "CORE_RAM_SECTIONS_ENABLE",
+        ],
+
+        # passing both scripts here keeps PlatformIO from adding LDSCRIPT_PATH a second time
+        # each script is in a group of its own, so the INSERT in core_sections.ld only moves its own sections
+        LINKFLAGS=[
+            "-Wl,--start-group",
+            "-Wl,-T,\"$LDSCRIPT_PATH\"",
+            "-Wl,--end-group",
+            "-Wl,--start-group",
+            f"-Wl,-T,\"{join(FRAMEWORK_DIR, 'tools', 'platformio', 'ld', 'core_sections.ld')}\"",
+            "-Wl,--end-group",
+        ]
+    )
+
 #
 # Target: Build Core Library
 #
@@ -24,6 +24,13 @@
 //
 #define BOARD_NR_GPIO_PINS 83
 
+//
+// GPIO port and bit of a pin number
+// pins are numbered as (port * 16) + bit, matching the order of PIN_MAP
+//
+#define VARIANT_GPIO_PIN_PORT(pin) ((pin) >> 4)
+#define VARIANT_GPIO_PIN_BIT(pin) ((pin) & 0x0f)
+
 //
 // GPIO pin aliases (index into PIN_MAP array)
 //